@@ -0,0 +1,81 @@
+#!/usr/bin/env bash
+# Runs a local dedicated server with N headless bot clients over localhost and collects their load test reports.
+#
+# Usage: Scripts/LoadTest/run_loadtest.sh [NumClients] [DurationSeconds] [Map]
+#
+# Set UE4_EDITOR to the UE4Editor binary to run from the editor build, or SERVER_BINARY and CLIENT_BINARY
+# to run packaged builds. SERVER_BINARY is normally the FG_NetServer target, whose report's MemoryMB, StartupSeconds
+# and TickTimeMs can be compared against a run with the game binary and -server.
+# Set BOT_SCRIPT to drive the bots from a script instead of seeded random input.
+set -euo pipefail
+
+NUM_CLIENTS=${1:-8}
+DURATION=${2:-120}
+MAP=${3:-/Game/Levels/MAP_Net}
+PORT=${PORT:-7777}
+SERVER_STARTUP_DELAY=${SERVER_STARTUP_DELAY:-15}
+
+PROJECT_DIR=$(cd "$(dirname "$0")/../.." && pwd)
+PROJECT="$PROJECT_DIR/FG_Net.uproject"
+REPORT_DIR=${REPORT_DIR:-"$PROJECT_DIR/Saved/LoadTest"}
+
+if [[ -n "${SERVER_BINARY:-}" ]]; then
+	SERVER_CMD=("$SERVER_BINARY")
+	CLIENT_CMD=("${CLIENT_BINARY:?Set CLIENT_BINARY together with SERVER_BINARY}")
+else
+	SERVER_CMD=("${UE4_EDITOR:?Set UE4_EDITOR or SERVER_BINARY and CLIENT_BINARY}" "$PROJECT" -server)
+	CLIENT_CMD=("$UE4_EDITOR" "$PROJECT" -game)
+fi
+
+BOT_ARGS=()
+if [[ -n "${BOT_SCRIPT:-}" ]]; then
+	BOT_ARGS+=("-FGBotScript=$BOT_SCRIPT")
+fi
+
+rm -rf "$REPORT_DIR"
+mkdir -p "$REPORT_DIR"
+
+PIDS=()
+cleanup() {
+	for PID in "${PIDS[@]}"; do
+		kill "$PID" 2>/dev/null || true
+	done
+}
+trap cleanup EXIT
+
+# The server outlives the clients slightly so the last seconds of traffic are part of its report
+"${SERVER_CMD[@]}" "$MAP" -port="$PORT" -log -unattended -nullrhi \
+	-FGLoadTest -FGLoadTestDuration=$((DURATION + SERVER_STARTUP_DELAY)) -FGLoadTestReportDir="$REPORT_DIR" \
+	> "$REPORT_DIR/server.log" 2>&1 &
+SERVER_PID=$!
+PIDS+=("$SERVER_PID")
+
+sleep "$SERVER_STARTUP_DELAY"
+
+CLIENT_PIDS=()
+for ((i = 0; i < NUM_CLIENTS; i++)); do
+	"${CLIENT_CMD[@]}" "127.0.0.1:$PORT" -log -unattended -nullrhi -nosound -windowed -ResX=320 -ResY=240 \
+		-FGBot -FGBotSeed="$i" ${BOT_ARGS[@]+"${BOT_ARGS[@]}"} \
+		-FGLoadTest -FGLoadTestDuration="$DURATION" -FGLoadTestReportDir="$REPORT_DIR" \
+		> "$REPORT_DIR/client_$i.log" 2>&1 &
+	CLIENT_PIDS+=($!)
+	PIDS+=($!)
+done
+
+wait "${CLIENT_PIDS[@]}" || true
+wait "$SERVER_PID" || true
+
+echo "Reports written to $REPORT_DIR"
+
+for REPORT in "$REPORT_DIR"/Server_*.json; do
+	[[ -f "$REPORT" ]] && cat "$REPORT"
+done
+
+CLIENT_CORRECTIONS=$(cat "$REPORT_DIR"/Client_*.json 2>/dev/null | awk -F: '/"Corrections"/ { gsub(/[ ,]/, "", $2); Sum += $2 } END { print Sum + 0 }')
+NUM_REPORTS=$(ls "$REPORT_DIR"/Client_*.json 2>/dev/null | wc -l)
+echo "Client reports: $NUM_REPORTS/$NUM_CLIENTS, total client corrections: $CLIENT_CORRECTIONS"
+
+if [[ "$NUM_REPORTS" -ne "$NUM_CLIENTS" ]] || ! ls "$REPORT_DIR"/Server_*.json > /dev/null 2>&1; then
+	echo "Load test did not produce all reports" >&2
+	exit 1
+fi
@@ -0,0 +1,21 @@
+#!/usr/bin/env bash
+# Replays a recording made with -FGRecord=<File> on a headless server, stepping at a fixed 60 Hz as fast as possible.
+#
+# Usage: Scripts/Replay/run_replay.sh <Recording> [Map]
+#
+# Set UE4_EDITOR to the UE4Editor binary, or SERVER_BINARY to a packaged server build.
+# The result, including a checksum of the final player state, is written to Saved/Replay/<Recording>_Result.txt.
+set -euo pipefail
+
+RECORDING=$(realpath "${1:?Usage: run_replay.sh <Recording> [Map]}")
+MAP=${2:-/Game/Levels/MAP_Net}
+
+PROJECT_DIR=$(cd "$(dirname "$0")/../.." && pwd)
+
+if [[ -n "${SERVER_BINARY:-}" ]]; then
+	SERVER_CMD=("$SERVER_BINARY")
+else
+	SERVER_CMD=("${UE4_EDITOR:?Set UE4_EDITOR or SERVER_BINARY}" "$PROJECT_DIR/FG_Net.uproject" -server)
+fi
+
+"${SERVER_CMD[@]}" "$MAP" -log -unattended -nullrhi -benchmark -fps=60 -FGReplay="$RECORDING"
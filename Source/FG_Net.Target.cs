@@ -9,6 +9,7 @@ public class FG_NetTarget : TargetRules
 	{
 		Type = TargetType.Game;
 		DefaultBuildSettings = BuildSettingsVersion.V2;
+		bWithPushModel = true;
 
 		ExtraModuleNames.AddRange( new string[] { "FG_Net" } );
 	}
@@ -2,18 +2,29 @@
 #include "../FGMovementStatics.h"
 #include "GameFramework/Actor.h"
 #include "Engine/World.h"
+#include "../Debug/FGNetStats.h"
+
+// How far below one the dot product of the component's and the facing rotation may be before a sleeping component wakes
+static const float SleepRotationTolerance = 1.e-6f;
 
 void UFGMovementComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
 {
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
-	FacingRotationCurrent = FQuat::Slerp(FacingRotationCurrent.Quaternion(), FacingRotationTarget.Quaternion(), FacingRotationSpeed * DeltaTime).Rotator();
+	// Slerping between two rotations around the same axis turns along the shorter way at a constant rate, so the yaw is
+	// stepped directly
+	const float DeltaYaw = FMath::FindDeltaAngleDegrees(FacingYawCurrent, FacingYawTarget);
+	const float Alpha = FacingRotationSpeed * DeltaTime;
 
-	if (FacingRotationCurrent.Equals(FacingRotationTarget))
+	if (FMath::Abs(DeltaYaw * (1.0f - Alpha)) <= KINDA_SMALL_NUMBER)
 	{
-		FacingRotationCurrent = FacingRotationTarget;
+		SetFacingYawCurrent(FacingYawTarget);
 		SetComponentTickEnabled(false);
 	}
+	else
+	{
+		SetFacingYawCurrent(FacingYawCurrent + DeltaYaw * Alpha);
+	}
 }
 
 FFGFrameMovement UFGMovementComponent::CreateFrameMovement() const
@@ -23,54 +34,84 @@ FFGFrameMovement UFGMovementComponent::CreateFrameMovement() const
 
 void UFGMovementComponent::Move(FFGFrameMovement& FrameMovement)
 {
+	SCOPE_CYCLE_COUNTER(STAT_FGMovementComponentMove);
+
+	if (bIsSleeping && !ShouldWakeUp(FrameMovement))
+	{
+		INC_DWORD_STAT(STAT_FGSleepingMoves);
+		FrameMovement.Hit = FloorHit;
+		FrameMovement.FinalLocation = SleepLocation;
+		return;
+	}
+
+	INC_DWORD_STAT(STAT_FGMovementSweeps);
+	bIsSleeping = false;
 	Hit.Reset();
 
 	FVector Delta = GetMovementDelta(FrameMovement);
-	MoveUpdatedComponent(Delta, FacingRotationCurrent, true, &Hit);
+	MoveUpdatedComponent(Delta, FacingQuatCurrent, true, &Hit);
 
 	if (Hit.bBlockingHit && FVector::DotProduct(FVector::UpVector, Hit.Normal) > 0.0f)
 	{
 		AccumulatedGravity = 0.0f;
 		Delta = GetMovementDelta(FrameMovement);
+		FloorHit = Hit;
 	}
 
 	SlideAlongSurface(Delta, 1.0f - Hit.Time, Hit.Normal, Hit);
 
 	FrameMovement.Hit = Hit;
 	FrameMovement.FinalLocation = UpdatedComponent->GetComponentLocation();
-}
 
-void UFGMovementComponent::ApplyGravity()
-{
-	AccumulatedGravity += Gravity * GetWorld()->GetDeltaSeconds();
+	// Gravity is only zero after landing on a floor, or for pawns that don't apply it
+	if (AccumulatedGravity == 0.0f && FrameMovement.GetMovementDelta().SizeSquared() < FMath::Square(SleepDistance))
+	{
+		bIsSleeping = true;
+		SleepLocation = FrameMovement.FinalLocation;
+		SleepFloorLocation = FloorHit.Component.IsValid() ? FloorHit.Component->GetComponentLocation() : FVector::ZeroVector;
+	}
 }
 
-void UFGMovementComponent::SetFacingRotation(const FRotator& InFacingRotation, float InRotationSpeed)
+bool UFGMovementComponent::ShouldWakeUp(const FFGFrameMovement& FrameMovement) const
 {
-	Internal_SetFacingRotation(InFacingRotation, InRotationSpeed);
-}
+	if (FrameMovement.GetMovementDelta().SizeSquared() >= FMath::Square(SleepDistance))
+	{
+		return true;
+	}
 
-void UFGMovementComponent::SetFacingRotation(const FQuat& InFacingRotation, float InRotationSpeed /*= -1.0f*/)
-{
-	Internal_SetFacingRotation(InFacingRotation.Rotator(), InRotationSpeed);
+	// Teleported, e.g. by a network correction, or turned
+	// q and -q are the same rotation, so compare the absolute dot product
+	if (!UpdatedComponent->GetComponentLocation().Equals(SleepLocation) || FMath::Abs(UpdatedComponent->GetComponentQuat() | FacingQuatCurrent) < 1.0f - SleepRotationTolerance)
+	{
+		return true;
+	}
+
+	// The floor moved or went away
+	if (FloorHit.bBlockingHit && (!FloorHit.Component.IsValid() || !FloorHit.Component->GetComponentLocation().Equals(SleepFloorLocation)))
+	{
+		return true;
+	}
+
+	return false;
 }
 
-void UFGMovementComponent::SetFacingDirection(const FVector& InFacingDirection, float InRotationSpeed /*= -1.0f*/)
+void UFGMovementComponent::ApplyGravity(float DeltaTime)
 {
-	Internal_SetFacingRotation(InFacingDirection.Rotation(), InRotationSpeed);
+	// A sleeping component is resting on its floor, so there's nothing for gravity to do until it wakes
+	if (!bIsSleeping)
+	{
+		AccumulatedGravity += Gravity * DeltaTime;
+	}
 }
 
-void UFGMovementComponent::Internal_SetFacingRotation(const FRotator& InFacingRotation, float InRotationSpeed)
+void UFGMovementComponent::SetFacingYaw(float InFacingYaw, float InRotationSpeed /*= -1.0f*/)
 {
-	FRotator NewRotation = InFacingRotation;
-	NewRotation.Roll = 0.0f;
-	NewRotation.Pitch = 0.0f;
-	FacingRotationTarget = NewRotation;
+	FacingYawTarget = FRotator::NormalizeAxis(InFacingYaw);
 	FacingRotationSpeed = InRotationSpeed;
 
 	if (InRotationSpeed < 0.0f)
 	{
-		FacingRotationCurrent = NewRotation;
+		SetFacingYawCurrent(FacingYawTarget);
 		SetComponentTickEnabled(false);
 	}
 	else
@@ -79,6 +120,34 @@ void UFGMovementComponent::Internal_SetFacingRotation(const FRotator& InFacingRo
 	}
 }
 
+void UFGMovementComponent::SetFacingRotation(const FRotator& InFacingRotation, float InRotationSpeed /*= -1.0f*/)
+{
+	SetFacingYaw(InFacingRotation.Yaw, InRotationSpeed);
+}
+
+void UFGMovementComponent::SetFacingRotation(const FQuat& InFacingRotation, float InRotationSpeed /*= -1.0f*/)
+{
+	// Same yaw as FQuat::Rotator, without working out pitch and roll
+	const float YawY = 2.0f * (InFacingRotation.W * InFacingRotation.Z + InFacingRotation.X * InFacingRotation.Y);
+	const float YawX = 1.0f - 2.0f * (FMath::Square(InFacingRotation.Y) + FMath::Square(InFacingRotation.Z));
+	SetFacingYaw(FMath::RadiansToDegrees(FMath::Atan2(YawY, YawX)), InRotationSpeed);
+}
+
+void UFGMovementComponent::SetFacingDirection(const FVector& InFacingDirection, float InRotationSpeed /*= -1.0f*/)
+{
+	SetFacingYaw(FMath::RadiansToDegrees(FMath::Atan2(InFacingDirection.Y, InFacingDirection.X)), InRotationSpeed);
+}
+
+void UFGMovementComponent::SetFacingYawCurrent(float InFacingYaw)
+{
+	FacingYawCurrent = FRotator::NormalizeAxis(InFacingYaw);
+
+	float Sin = 0.0f;
+	float Cos = 1.0f;
+	FMath::SinCos(&Sin, &Cos, FMath::DegreesToRadians(FacingYawCurrent) * 0.5f);
+	FacingQuatCurrent = FQuat(0.0f, 0.0f, Sin, Cos);
+}
+
 FVector UFGMovementComponent::GetMovementDelta(const FFGFrameMovement& FrameMovement) const
 {
 	return FrameMovement.GetMovementDelta() - GetGravityAsVector();
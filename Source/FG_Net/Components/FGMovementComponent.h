@@ -13,28 +13,46 @@ public:
 	UPROPERTY(EditAnywhere, Category = Movement)
 	float Gravity = 30.0f;
 
+	// Moves shorter than this while standing on the floor put the component to sleep, skipping sweeps until it is woken
+	UPROPERTY(EditAnywhere, Category = Movement, meta = (ClampMin = 0.0))
+	float SleepDistance = 0.05f;
+
 	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
 
 	FFGFrameMovement CreateFrameMovement() const;
 	
 	void Move(FFGFrameMovement& FrameMovement);
-	void ApplyGravity();
+	void ApplyGravity(float DeltaTime);
 
 	FVector GetGravityAsVector() const { return FVector(0.0f, 0.0f, AccumulatedGravity); }
-	FRotator GetFacingRotation() const { return FacingRotationCurrent; }
-	FVector GetFacingDirection() const { return FacingRotationCurrent.Vector(); }
-
+	FRotator GetFacingRotation() const { return FRotator(0.0f, FacingYawCurrent, 0.0f); }
+	FQuat GetFacingQuat() const { return FacingQuatCurrent; }
+	FVector GetFacingDirection() const { return FacingQuatCurrent.GetForwardVector(); }
+	float GetFacingYaw() const { return FacingYawCurrent; }
+	bool IsSleeping() const { return bIsSleeping; }
+	void WakeUp() { bIsSleeping = false; }
+
+	// Facing only has yaw, pitch and roll are dropped. A negative rotation speed turns immediately.
+	void SetFacingYaw(float InFacingYaw, float InRotationSpeed = -1.0f);
 	void SetFacingRotation(const FRotator& InFacingRotation, float InRotationSpeed = -1.0f);
 	void SetFacingRotation(const FQuat& InFacingRotation, float InRotationSpeed = -1.0f);
 	void SetFacingDirection(const FVector& InFacingDirection, float InRotationSpeed = -1.0f);
 
 private:
-	void Internal_SetFacingRotation(const FRotator& InFacingRotation, float InRotationSpeed);
+	void SetFacingYawCurrent(float InFacingYaw);
 	FVector GetMovementDelta(const FFGFrameMovement& FrameMovement) const;
+	bool ShouldWakeUp(const FFGFrameMovement& FrameMovement) const;
 
 	FHitResult Hit;
-	FRotator FacingRotationCurrent;
-	FRotator FacingRotationTarget;
+	// Last floor the component landed on, and where it and the component were when it fell asleep
+	FHitResult FloorHit;
+	FVector SleepLocation = FVector::ZeroVector;
+	FVector SleepFloorLocation = FVector::ZeroVector;
+	bool bIsSleeping = false;
+	// Yaw in degrees, with the matching quaternion the updated component is moved with
+	float FacingYawCurrent = 0.0f;
+	float FacingYawTarget = 0.0f;
+	FQuat FacingQuatCurrent = FQuat::Identity;
 	float AccumulatedGravity = 0.0f;
 	float FacingRotationSpeed = 1.0f;
 };
@@ -0,0 +1,80 @@
+#include "FGCrumbTrail.h"
+
+void FFGCrumbTrail::AddCrumb(float Value, int32 MaxCrumbs)
+{
+	Crumbs.Add(Value);
+
+	if (MaxCrumbs > 0 && Crumbs.Num() >= MaxCrumbs)
+	{
+		Crumbs.RemoveAt(0, 1, false);
+	}
+}
+
+void FFGCrumbTrail::Consume(float& CurrentValue, float DeltaTime, float CrumbDuration, bool bHasReceivedTerminalValue, EFGSmoothReplicatorMode SmoothMode)
+{
+	if (Crumbs.Num() == 0)
+	{
+		return;
+	}
+
+	const float TrailLength = (CrumbDuration * (float)Crumbs.Num()) - (CrumbDuration - CurrentCrumbTimeRemaining);
+	float LerpSpeed = 1.0f;
+
+	// If we're getting close to the end of the trail we slow down consumption
+	if (TrailLength < CrumbDuration * 0.5f && !bHasReceivedTerminalValue)
+	{
+		LerpSpeed *= TrailLength / (CrumbDuration * 0.5f);
+	}
+	// If the crumb trail is getting to big we should increase consumption
+	else if (TrailLength > CrumbDuration * 2.5f)
+	{
+		LerpSpeed *= (TrailLength / (CrumbDuration * 2.5f));
+	}
+
+	float FrameTarget = CurrentValue;
+	float FrameTargetFuture = 0.0f;
+
+	float RemainingLerp = LerpSpeed * DeltaTime;
+
+	while (Crumbs.Num() > 0 && RemainingLerp > 0.001f)
+	{
+		float ConsumeLerp = FMath::Min(CurrentCrumbTimeRemaining, RemainingLerp);
+		float CrumbSize = CurrentCrumbTimeRemaining;
+
+		RemainingLerp -= ConsumeLerp;
+		CurrentCrumbTimeRemaining -= ConsumeLerp;
+
+		if (CurrentCrumbTimeRemaining <= 0.001f)
+		{
+			FrameTarget = Crumbs[0];
+			FrameTargetFuture = 0.0f;
+
+			Crumbs.RemoveAt(0);
+			CurrentCrumbTimeRemaining = CrumbDuration;
+		}
+		else
+		{
+			FrameTarget = Crumbs[0];
+			FrameTargetFuture = CrumbSize - ConsumeLerp;
+		}
+	}
+
+	if (FrameTarget != CurrentValue)
+	{
+		if (FrameTargetFuture == 0.0f)
+		{
+			CurrentValue = FrameTarget;
+		}
+		else
+		{
+			const float AdvanceTime = (LerpSpeed * DeltaTime) - RemainingLerp;
+			const float TimeToTarget = FrameTargetFuture + AdvanceTime;
+
+			if (SmoothMode == EFGSmoothReplicatorMode::ConstantVelocity)
+			{
+				const float Alpha = FMath::Clamp(AdvanceTime / TimeToTarget, 0.0f, 1.0f);
+				TFGSmoothReplicatorOperation<float>::InterpConstantVelocity(CurrentValue, FrameTarget, Alpha);
+			}
+		}
+	}
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FGReplicatorBase.h"
+
+// Trail of received values that is consumed at one crumb per replication interval
+struct FFGCrumbTrail
+{
+	// MaxCrumbs <= 0 means the trail is never trimmed
+	void AddCrumb(float Value, int32 MaxCrumbs = 0);
+	void Consume(float& CurrentValue, float DeltaTime, float CrumbDuration, bool bHasReceivedTerminalValue, EFGSmoothReplicatorMode SmoothMode);
+
+	int32 Num() const { return Crumbs.Num(); }
+
+private:
+	TArray<float, TInlineAllocator<10>> Crumbs;
+	float CurrentCrumbTimeRemaining = 0.0f;
+};
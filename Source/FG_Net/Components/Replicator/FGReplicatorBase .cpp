@@ -3,6 +3,7 @@
 #include "Engine/World.h"
 #include "Engine/Engine.h"
 #include "Net/UnrealNetwork.h"
+#include "FGReplicatorComponent.h"
 
 int32 UFGReplicatorBase::GetFunctionCallspace(UFunction* Function, FFrame* Stack)
 {
@@ -58,7 +59,33 @@ bool UFGReplicatorBase::IsTickable() const
 
 void UFGReplicatorBase::SetShouldTick(bool bInShouldTick)
 {
+	if (bShouldTick == bInShouldTick)
+	{
+		return;
+	}
+
 	bShouldTick = bInShouldTick;
+
+	if (UFGReplicatorComponent* Component = OwningComponent.Get())
+	{
+		Component->UpdateOwnerDormancy();
+	}
+}
+
+void UFGReplicatorBase::SetOwningComponent(UFGReplicatorComponent* InOwningComponent)
+{
+	OwningComponent = InOwningComponent;
+}
+
+void UFGReplicatorBase::FlushOwnerDormancy()
+{
+	if (AActor* OwnerActor = Cast<AActor>(GetOuter()))
+	{
+		if (OwnerActor->HasAuthority())
+		{
+			OwnerActor->FlushNetDormancy();
+		}
+	}
 }
 
 bool UFGReplicatorBase::IsTicking() const
@@ -4,6 +4,8 @@
 #include "Tickable.h"
 #include "FGReplicatorBase.generated.h"
 
+class UFGReplicatorComponent;
+
 UENUM()
 enum class EFGSmoothReplicatorMode : uint8
 {
@@ -45,6 +47,13 @@ public:
 	bool IsLocallyControlled() const;
 	bool HasAuthority() const;
 
+	void SetOwningComponent(UFGReplicatorComponent* InOwningComponent);
+
+protected:
+	// Pushes state changed while the owner is dormant
+	void FlushOwnerDormancy();
+
 private:
+	TWeakObjectPtr<UFGReplicatorComponent> OwningComponent;
 	bool bShouldTick = false;
 };
\ No newline at end of file
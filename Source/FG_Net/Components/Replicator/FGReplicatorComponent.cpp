@@ -2,6 +2,7 @@
 #include "Net/UnrealNetwork.h"
 #include "Engine/ActorChannel.h"
 #include "FGReplicatorBase.h"
+#include "GameFramework/Pawn.h"
 
 UFGReplicatorComponent::UFGReplicatorComponent()
 {
@@ -19,7 +20,31 @@ bool UFGReplicatorComponent::ReplicateSubobjects(class UActorChannel* Channel, c
 UFGReplicatorBase* UFGReplicatorComponent::AddReplicatorByClass(TSubclassOf<UFGReplicatorBase> ClassType, FName Name)
 {
 	UFGReplicatorBase* NewReplicator = NewObject<UFGReplicatorBase>(GetOwner(), ClassType, Name);
+	NewReplicator->SetOwningComponent(this);
 	NewReplicator->Init();
 	SmoothReplicators.Add(NewReplicator);
+	UpdateOwnerDormancy();
 	return NewReplicator;
+}
+
+void UFGReplicatorComponent::UpdateOwnerDormancy()
+{
+	AActor* OwnerActor = GetOwner();
+
+	if (!bManageOwnerDormancy || OwnerActor == nullptr || !OwnerActor->HasAuthority() || OwnerActor->IsA<APawn>())
+	{
+		return;
+	}
+
+	const bool bAnyReplicatorAwake = SmoothReplicators.ContainsByPredicate([](const UFGReplicatorBase* Replicator)
+	{
+		return Replicator != nullptr && Replicator->IsTicking();
+	});
+
+	const ENetDormancy WantedDormancy = bAnyReplicatorAwake ? DORM_Awake : DORM_DormantAll;
+
+	if (OwnerActor->NetDormancy != WantedDormancy)
+	{
+		OwnerActor->SetNetDormancy(WantedDormancy);
+	}
 }
\ No newline at end of file
@@ -23,6 +23,12 @@ public:
 		return CastChecked<ClassType>(AddReplicatorByClass(ClassType::StaticClass(), Name));
 	}
 
+	// Puts the owner to sleep on the server while every replicator is sleeping. Pawns are never made dormant.
+	void UpdateOwnerDormancy();
+
+	UPROPERTY(EditAnywhere, Category = Network)
+	bool bManageOwnerDormancy = true;
+
 private:
 	UPROPERTY()
 	TArray<UFGReplicatorBase*> SmoothReplicators;
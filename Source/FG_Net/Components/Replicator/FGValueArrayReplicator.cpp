@@ -0,0 +1,257 @@
+#include "FGValueArrayReplicator.h"
+#include "Net/UnrealNetwork.h"
+#include "../../Debug/FGNetStats.h"
+#include "../../Debug/FGCorrectionTelemetry.h"
+
+void FFGReplicatedValueItem::PostReplicatedAdd(const FFGReplicatedValueArray& InArraySerializer)
+{
+	CurrentValue = Value;
+	bHasReceivedTerminalValue = bIsTerminal;
+
+	if (InArraySerializer.Owner != nullptr)
+	{
+		InArraySerializer.Owner->OnItemAdded(*this);
+	}
+}
+
+void FFGReplicatedValueItem::PostReplicatedChange(const FFGReplicatedValueArray& InArraySerializer)
+{
+	if (InArraySerializer.Owner == nullptr)
+	{
+		return;
+	}
+
+	if (bIsTerminal)
+	{
+		CrumbTrail.AddCrumb(Value);
+	}
+	else
+	{
+		if (bHasReceivedTerminalValue && CrumbTrail.Num() == 0)
+		{
+			CrumbTrail.AddCrumb(CurrentValue);
+		}
+
+		CrumbTrail.AddCrumb(Value, InArraySerializer.Owner->NumberOfReplicationsPerSecond * 2);
+		FFGCorrectionTelemetry::RecordCrumbTrailDepth(CrumbTrail.Num());
+	}
+
+	bHasReceivedTerminalValue = bIsTerminal;
+	InArraySerializer.Owner->OnItemChanged(*this);
+}
+
+void FFGReplicatedValueItem::PreReplicatedRemove(const FFGReplicatedValueArray& InArraySerializer)
+{
+	if (InArraySerializer.Owner != nullptr)
+	{
+		InArraySerializer.Owner->OnItemRemoved(*this);
+	}
+}
+
+void UFGValueArrayReplicator::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(UFGValueArrayReplicator, ReplicatedValues);
+}
+
+void UFGValueArrayReplicator::Init()
+{
+	ReplicatedValues.Owner = this;
+}
+
+void UFGValueArrayReplicator::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_FGValueReplicatorTick);
+	CSV_SCOPED_TIMING_STAT(FGNet, ValueReplicatorTick);
+
+	const float CrumbDuration = (1.0f / static_cast<float>(NumberOfReplicationsPerSecond));
+
+	if (HasAuthority())
+	{
+		SyncTimer -= DeltaTime;
+
+		if (SyncTimer <= 0.0f)
+		{
+			for (auto It = AwakeKeys.CreateIterator(); It; ++It)
+			{
+				FFGReplicatedValueItem* Item = FindItem(*It);
+
+				if (Item == nullptr)
+				{
+					It.RemoveCurrent();
+					continue;
+				}
+
+				if (Item->CurrentValue != Item->Value)
+				{
+					Item->Value = Item->CurrentValue;
+					Item->bIsTerminal = false;
+					Item->StaticValueTimer = 0.0f;
+					ReplicatedValues.MarkItemDirty(*Item);
+				}
+				else
+				{
+					Item->StaticValueTimer += CrumbDuration;
+
+					if (Item->StaticValueTimer >= SleepAfterDuration)
+					{
+						Item->bIsTerminal = true;
+						ReplicatedValues.MarkItemDirty(*Item);
+						It.RemoveCurrent();
+					}
+				}
+			}
+
+			SyncTimer += CrumbDuration;
+		}
+	}
+	else
+	{
+		for (auto It = AwakeKeys.CreateIterator(); It; ++It)
+		{
+			FFGReplicatedValueItem* Item = FindItem(*It);
+
+			if (Item == nullptr)
+			{
+				It.RemoveCurrent();
+				continue;
+			}
+
+			Item->CrumbTrail.Consume(Item->CurrentValue, DeltaTime, CrumbDuration, Item->bHasReceivedTerminalValue, SmoothMode);
+
+			if (Item->bHasReceivedTerminalValue && Item->CrumbTrail.Num() == 0)
+			{
+				It.RemoveCurrent();
+			}
+		}
+	}
+
+	if (AwakeKeys.Num() == 0)
+	{
+		SetShouldTick(false);
+	}
+}
+
+void UFGValueArrayReplicator::SetValue(int32 Key, float InValue)
+{
+	if (!HasAuthority())
+	{
+		return;
+	}
+
+	if (FFGReplicatedValueItem* Item = FindItem(Key))
+	{
+		if (Item->CurrentValue == InValue)
+		{
+			return;
+		}
+
+		Item->CurrentValue = InValue;
+		Item->StaticValueTimer = 0.0f;
+
+		if (AwakeKeys.Num() == 0)
+		{
+			SyncTimer = 0.0f;
+		}
+
+		AwakeKeys.Add(Key);
+		SetShouldTick(true);
+	}
+	else
+	{
+		FFGReplicatedValueItem& NewItem = ReplicatedValues.Items.AddDefaulted_GetRef();
+		NewItem.Key = Key;
+		NewItem.Value = InValue;
+		NewItem.CurrentValue = InValue;
+		ReplicatedValues.MarkItemDirty(NewItem);
+		bKeyToIndexDirty = true;
+		FlushOwnerDormancy();
+	}
+
+	OnValueChanged.Broadcast(Key);
+}
+
+void UFGValueArrayReplicator::RemoveValue(int32 Key)
+{
+	if (!HasAuthority())
+	{
+		return;
+	}
+
+	const int32 NumRemoved = ReplicatedValues.Items.RemoveAll([Key](const FFGReplicatedValueItem& Item) { return Item.Key == Key; });
+
+	if (NumRemoved > 0)
+	{
+		AwakeKeys.Remove(Key);
+		ReplicatedValues.MarkArrayDirty();
+		bKeyToIndexDirty = true;
+		FlushOwnerDormancy();
+	}
+}
+
+float UFGValueArrayReplicator::GetValue(int32 Key) const
+{
+	const FFGReplicatedValueItem* Item = FindItem(Key);
+	return Item != nullptr ? Item->CurrentValue : 0.0f;
+}
+
+bool UFGValueArrayReplicator::HasValue(int32 Key) const
+{
+	return FindItem(Key) != nullptr;
+}
+
+void UFGValueArrayReplicator::OnItemAdded(const FFGReplicatedValueItem& Item)
+{
+	bKeyToIndexDirty = true;
+	OnValueChanged.Broadcast(Item.Key);
+}
+
+void UFGValueArrayReplicator::OnItemChanged(const FFGReplicatedValueItem& Item)
+{
+	AwakeKeys.Add(Item.Key);
+	SetShouldTick(true);
+	OnValueChanged.Broadcast(Item.Key);
+}
+
+void UFGValueArrayReplicator::OnItemRemoved(const FFGReplicatedValueItem& Item)
+{
+	AwakeKeys.Remove(Item.Key);
+	bKeyToIndexDirty = true;
+}
+
+FFGReplicatedValueItem* UFGValueArrayReplicator::FindItem(int32 Key)
+{
+	return const_cast<FFGReplicatedValueItem*>(static_cast<const UFGValueArrayReplicator*>(this)->FindItem(Key));
+}
+
+const FFGReplicatedValueItem* UFGValueArrayReplicator::FindItem(int32 Key) const
+{
+	if (bKeyToIndexDirty)
+	{
+		RebuildKeyToIndex();
+	}
+
+	const int32* Index = KeyToIndex.Find(Key);
+
+	// Removed items are only taken out of the array after the replication callbacks, so validate the cached index
+	if (Index != nullptr && (!ReplicatedValues.Items.IsValidIndex(*Index) || ReplicatedValues.Items[*Index].Key != Key))
+	{
+		RebuildKeyToIndex();
+		Index = KeyToIndex.Find(Key);
+	}
+
+	return Index != nullptr ? &ReplicatedValues.Items[*Index] : nullptr;
+}
+
+void UFGValueArrayReplicator::RebuildKeyToIndex() const
+{
+	KeyToIndex.Reset();
+
+	for (int32 Index = 0; Index < ReplicatedValues.Items.Num(); ++Index)
+	{
+		KeyToIndex.Add(ReplicatedValues.Items[Index].Key, Index);
+	}
+
+	bKeyToIndexDirty = false;
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "FGReplicatorBase.h"
+#include "FGCrumbTrail.h"
+#include "Engine/NetSerialization.h"
+#include "FGValueArrayReplicator.generated.h"
+
+class UFGValueArrayReplicator;
+struct FFGReplicatedValueArray;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FFGOnArrayValueChanged, int32, Key);
+
+USTRUCT()
+struct FFGReplicatedValueItem : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+public:
+	UPROPERTY()
+	int32 Key = 0;
+
+	UPROPERTY()
+	float Value = 0.0f;
+
+	UPROPERTY()
+	bool bIsTerminal = true;
+
+	// Latest value set on the server, smoothed value on clients
+	float CurrentValue = 0.0f;
+	float StaticValueTimer = 0.0f;
+	bool bHasReceivedTerminalValue = true;
+	FFGCrumbTrail CrumbTrail;
+
+	void PostReplicatedAdd(const FFGReplicatedValueArray& InArraySerializer);
+	void PostReplicatedChange(const FFGReplicatedValueArray& InArraySerializer);
+	void PreReplicatedRemove(const FFGReplicatedValueArray& InArraySerializer);
+};
+
+USTRUCT()
+struct FFGReplicatedValueArray : public FFastArraySerializer
+{
+	GENERATED_BODY()
+public:
+	UPROPERTY()
+	TArray<FFGReplicatedValueItem> Items;
+
+	UFGValueArrayReplicator* Owner = nullptr;
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FFGReplicatedValueItem, FFGReplicatedValueArray>(Items, DeltaParms, *this);
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FFGReplicatedValueArray> : public TStructOpsTypeTraitsBase2<FFGReplicatedValueArray>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
+
+// Server authored collection of smoothed values. Only items that changed since the last send are serialized.
+UCLASS()
+class FG_NET_API UFGValueArrayReplicator : public UFGReplicatorBase
+{
+	GENERATED_BODY()
+public:
+	virtual void Tick(float DeltaTime) override;
+	virtual void Init() override;
+
+	UFUNCTION(BlueprintCallable, Category = Network)
+	void SetValue(int32 Key, float InValue);
+
+	UFUNCTION(BlueprintCallable, Category = Network)
+	void RemoveValue(int32 Key);
+
+	UFUNCTION(BlueprintPure, Category = Network)
+	float GetValue(int32 Key) const;
+
+	UFUNCTION(BlueprintPure, Category = Network)
+	bool HasValue(int32 Key) const;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, meta = (ClampMin = 1))
+	int32 NumberOfReplicationsPerSecond = 5;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	EFGSmoothReplicatorMode SmoothMode = EFGSmoothReplicatorMode::ConstantVelocity;
+
+	UPROPERTY(BlueprintAssignable)
+	FFGOnArrayValueChanged OnValueChanged;
+
+private:
+	friend struct FFGReplicatedValueItem;
+
+	void OnItemAdded(const FFGReplicatedValueItem& Item);
+	void OnItemChanged(const FFGReplicatedValueItem& Item);
+	void OnItemRemoved(const FFGReplicatedValueItem& Item);
+
+	FFGReplicatedValueItem* FindItem(int32 Key);
+	const FFGReplicatedValueItem* FindItem(int32 Key) const;
+	void RebuildKeyToIndex() const;
+
+	UPROPERTY(Replicated)
+	FFGReplicatedValueArray ReplicatedValues;
+
+	// Keys that are waiting to be sent on the server or still have crumbs to consume on clients
+	TSet<int32> AwakeKeys;
+
+	mutable TMap<int32, int32> KeyToIndex;
+	mutable bool bKeyToIndexDirty = true;
+
+	float SyncTimer = 0.0f;
+	float SleepAfterDuration = 1.0f;
+};
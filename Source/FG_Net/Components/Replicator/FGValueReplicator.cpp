@@ -1,8 +1,15 @@
 #include "FGValueReplicator.h"
 #include "Net/UnrealNetwork.h"
+#include "GameFramework/Pawn.h"
+#include "../../Debug/FGNetStats.h"
+#include "../../Debug/FGCorrectionTelemetry.h"
+#include "../../Debug/FGNetRecorder.h"
 
 void UFGValueReplicator::Tick(float DeltaTime)
 {
+	SCOPE_CYCLE_COUNTER(STAT_FGValueReplicatorTick);
+	CSV_SCOPED_TIMING_STAT(FGNet, ValueReplicatorTick);
+
 	float CrumbDuration = (1.0f / static_cast<float>(NumberOfReplicationsPerSecond));
 
 	if (IsLocallyControlled())
@@ -30,13 +37,19 @@ void UFGValueReplicator::Tick(float DeltaTime)
 			{
 				if (!bHasSentTerminalValue)
 				{
-					Server_SendTerminalValue(NextSyncTag++, ReplicatedValueCurrent);
+					{
+						FFGScopedRPCStat RPCStat(EFGNetRPCType::Replicator, *GetOwner());
+						Server_SendTerminalValue(NextSyncTag++, ReplicatedValueCurrent);
+					}
 					bHasSentTerminalValue = true;
 				}
 			}
 			else
 			{
-				Server_SendReplicatedValue(NextSyncTag++, ReplicatedValueCurrent);
+				{
+					FFGScopedRPCStat RPCStat(EFGNetRPCType::Replicator, *GetOwner());
+					Server_SendReplicatedValue(NextSyncTag++, ReplicatedValueCurrent);
+				}
 				bHasSentTerminalValue = false;
 			}
 
@@ -46,69 +59,7 @@ void UFGValueReplicator::Tick(float DeltaTime)
 	}
 	else
 	{
-		if (CrumbTrail.Num() != 0)
-		{
-			const float TrailLength = (CrumbDuration * (float)CrumbTrail.Num()) - (CrumbDuration - CurrentCrumbTimeRemaining);
-			LerpSpeed = 1.0f;
-
-			// If we're getting close to the end of the trail we slow down consumption
-			if (TrailLength < CrumbDuration * 0.5f && !bHasReceivedTerminalValue)
-			{
-				LerpSpeed *= TrailLength / (CrumbDuration * 0.5f);
-			}
-			// If the crumb trail is getting to big we should increase consumption
-			else if (TrailLength > CrumbDuration * 2.5f)
-			{
-				LerpSpeed *= (TrailLength / (CrumbDuration * 2.5f));
-			}
-
-			float FrameTarget = ReplicatedValueCurrent;
-			float FrameTargetFuture = 0.0f;
-
-			float RemainingLerp = LerpSpeed * DeltaTime;
-			
-			while (CrumbTrail.Num() > 0 && RemainingLerp > 0.001f)
-			{
-				float ConsumeLerp = FMath::Min(CurrentCrumbTimeRemaining, RemainingLerp);
-				float CrumbSize = CurrentCrumbTimeRemaining;
-
-				RemainingLerp -= ConsumeLerp;
-				CurrentCrumbTimeRemaining -= ConsumeLerp;
-
-				if (CurrentCrumbTimeRemaining <= 0.001f)
-				{
-					FrameTarget = CrumbTrail[0].Value;
-					FrameTargetFuture = 0.0f;
-
-					CrumbTrail.RemoveAt(0);
-					CurrentCrumbTimeRemaining = CrumbDuration;
-				}
-				else
-				{
-					FrameTarget = CrumbTrail[0].Value;
-					FrameTargetFuture = CrumbSize - ConsumeLerp;
-				}
-			}
-
-			if (FrameTarget != ReplicatedValueCurrent)
-			{
-				if (FrameTargetFuture == 0.0f)
-				{
-					ReplicatedValueCurrent = FrameTarget;
-				}
-				else
-				{
-					const float AdvanceTime = (LerpSpeed * DeltaTime) - RemainingLerp;
-					const float TimeToTarget = FrameTargetFuture + AdvanceTime;
-
-					if (SmoothMode == EFGSmoothReplicatorMode::ConstantVelocity)
-					{
-						const float Alpha = FMath::Clamp(AdvanceTime / TimeToTarget, 0.0f, 1.0f);
-						TFGSmoothReplicatorOperation<float>::InterpConstantVelocity(ReplicatedValueCurrent, FrameTarget, Alpha);
-					}
-				}
-			}
-		}
+		CrumbTrail.Consume(ReplicatedValueCurrent, DeltaTime, CrumbDuration, bHasReceivedTerminalValue, SmoothMode);
 	}
 
 	if (!ShouldTick())
@@ -166,8 +117,17 @@ void UFGValueReplicator::BroadcastDelegate()
 	}
 }
 
+void UFGValueReplicator::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME_CONDITION(UFGValueReplicator, RelayedValue, COND_SkipOwner);
+}
+
 void UFGValueReplicator::Server_SendTerminalValue_Implementation(int32 SyncTag, float TerminalValue)
 {
+	FFGNetRecorder::RecordReplicatorValue(*this, SyncTag, TerminalValue, true);
+
 	if (SyncTag < LastReceivedSyncTag)
 	{
 		return;
@@ -175,21 +135,84 @@ void UFGValueReplicator::Server_SendTerminalValue_Implementation(int32 SyncTag,
 
 	LastReceivedSyncTag = SyncTag;
 
-	Multicast_SendTerminalValue(SyncTag, TerminalValue);
+	RelayValue(SyncTag, TerminalValue, true);
 }
 
 void UFGValueReplicator::Server_SendReplicatedValue_Implementation(int32 SyncTag, float ReplicatedValue)
 {
+	FFGNetRecorder::RecordReplicatorValue(*this, SyncTag, ReplicatedValue, false);
+
 	if (SyncTag < LastReceivedSyncTag)
 	{
 		return;
 	}
 
 	LastReceivedSyncTag = SyncTag;
-	Mulitcast_SendReplicatedValue(SyncTag, ReplicatedValue);
+	RelayValue(SyncTag, ReplicatedValue, false);
+}
+
+bool UFGValueReplicator::ShouldRelayToNonOwnersOnly() const
+{
+	const APawn* PawnOuter = Cast<APawn>(GetOuter());
+	return PawnOuter != nullptr && !PawnOuter->IsLocallyControlled();
+}
+
+void UFGValueReplicator::RelayValue(int32 SyncTag, float Value, bool bIsTerminal)
+{
+	if (!ShouldRelayToNonOwnersOnly())
+	{
+		FFGScopedRPCStat RPCStat(EFGNetRPCType::Replicator, GetOwner()->GetNetDriver());
+
+		if (bIsTerminal)
+		{
+			Multicast_SendTerminalValue(SyncTag, Value);
+		}
+		else
+		{
+			Mulitcast_SendReplicatedValue(SyncTag, Value);
+		}
+
+		return;
+	}
+
+	// The server keeps its own smoothed copy, the property then reaches every connection except the owner
+	if (bIsTerminal)
+	{
+		ReceiveTerminalValue(SyncTag, Value);
+	}
+	else
+	{
+		ReceiveReplicatedValue(SyncTag, Value);
+	}
+
+	RelayedValue.SyncTag = SyncTag;
+	RelayedValue.Value = Value;
+	RelayedValue.bIsTerminal = bIsTerminal;
+}
+
+void UFGValueReplicator::OnRep_RelayedValue()
+{
+	if (RelayedValue.bIsTerminal)
+	{
+		ReceiveTerminalValue(RelayedValue.SyncTag, RelayedValue.Value);
+	}
+	else
+	{
+		ReceiveReplicatedValue(RelayedValue.SyncTag, RelayedValue.Value);
+	}
 }
 
 void UFGValueReplicator::Multicast_SendTerminalValue_Implementation(int32 SyncTag, float TerminalValue)
+{
+	ReceiveTerminalValue(SyncTag, TerminalValue);
+}
+
+void UFGValueReplicator::Mulitcast_SendReplicatedValue_Implementation(int32 SyncTag, float ReplicatedValue)
+{
+	ReceiveReplicatedValue(SyncTag, ReplicatedValue);
+}
+
+void UFGValueReplicator::ReceiveTerminalValue(int32 SyncTag, float TerminalValue)
 {
 	if (IsLocallyControlled())
 	{
@@ -204,13 +227,12 @@ void UFGValueReplicator::Multicast_SendTerminalValue_Implementation(int32 SyncTa
 	LastReceivedSyncTag = SyncTag;
 	bHasReceivedTerminalValue = true;
 	
-	auto& Crumb = CrumbTrail.Emplace_GetRef();
-	Crumb.Value = TerminalValue;
+	CrumbTrail.AddCrumb(TerminalValue);
 	
 	SetShouldTick(true);
 }
 
-void UFGValueReplicator::Mulitcast_SendReplicatedValue_Implementation(int32 SyncTag, float ReplicatedValue)
+void UFGValueReplicator::ReceiveReplicatedValue(int32 SyncTag, float ReplicatedValue)
 {
 	if (IsLocallyControlled())
 	{
@@ -226,21 +248,15 @@ void UFGValueReplicator::Mulitcast_SendReplicatedValue_Implementation(int32 Sync
 	{
 		if (CrumbTrail.Num() == 0)
 		{
-			auto& WaitCrumb = CrumbTrail.Emplace_GetRef();
-			WaitCrumb.Value = ReplicatedValueCurrent;
+			CrumbTrail.AddCrumb(ReplicatedValueCurrent);
 		}
 	}
 
 	LastReceivedSyncTag = SyncTag;
 	bHasReceivedTerminalValue = false;
 
-	auto& Crumb = CrumbTrail.Emplace_GetRef();
-	Crumb.Value = ReplicatedValue;
-
-	if (CrumbTrail.Num() >= NumberOfReplicationsPerSecond * 2)
-	{
-		CrumbTrail.RemoveAt(0, 1, false);
-	}
+	CrumbTrail.AddCrumb(ReplicatedValue, NumberOfReplicationsPerSecond * 2);
+	FFGCorrectionTelemetry::RecordCrumbTrailDepth(CrumbTrail.Num());
 
 	SetShouldTick(true);
 }
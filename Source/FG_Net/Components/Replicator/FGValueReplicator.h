@@ -1,14 +1,31 @@
 #pragma once
 
 #include "FGReplicatorBase.h"
+#include "FGCrumbTrail.h"
 #include "FGValueReplicator.generated.h"
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FFGOnSmoothValueReplicationChanged);
 
+USTRUCT()
+struct FFGValueReplicatorRelay
+{
+	GENERATED_BODY()
+public:
+	UPROPERTY()
+	int32 SyncTag = -1;
+
+	UPROPERTY()
+	float Value = 0.0f;
+
+	UPROPERTY()
+	bool bIsTerminal = true;
+};
+
 UCLASS()
 class FG_NET_API UFGValueReplicator : public UFGReplicatorBase
 {
 	GENERATED_BODY()
+	friend class FFGNetReplay;
 public:
 	virtual void Tick(float DeltaTime) override;
 	virtual void Init() override;
@@ -45,12 +62,20 @@ public:
 private:
 	void BroadcastDelegate();
 
-	struct FCrumb
-	{
-		float Value;
-	};
+	// Pawn owned values are written by the owning client, so they are relayed through a property that skips the owner
+	bool ShouldRelayToNonOwnersOnly() const;
+	void RelayValue(int32 SyncTag, float Value, bool bIsTerminal);
+
+	void ReceiveTerminalValue(int32 SyncTag, float TerminalValue);
+	void ReceiveReplicatedValue(int32 SyncTag, float ReplicatedValue);
+
+	UFUNCTION()
+	void OnRep_RelayedValue();
+
+	UPROPERTY(ReplicatedUsing = OnRep_RelayedValue)
+	FFGValueReplicatorRelay RelayedValue;
 
-	TArray<FCrumb, TInlineAllocator<10>> CrumbTrail;
+	FFGCrumbTrail CrumbTrail;
 
 	float ReplicatedValueTarget = 0.0f;
 	float ReplicatedValueCurrent = 0.0f;
@@ -63,8 +88,6 @@ private:
 	int32 LastReceivedCrumbSyncTag = -1;
 
 	float SyncTimer = 0.0f;
-	float LerpSpeed = 1.0f;
-	float CurrentCrumbTimeRemaining = 0.0f;
 
 	bool bHasReceivedTerminalValue = false;
 	bool bHasSentTerminalValue = false;
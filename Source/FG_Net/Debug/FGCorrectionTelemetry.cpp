@@ -0,0 +1,306 @@
+#include "FGCorrectionTelemetry.h"
+#include "FGNetStats.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/OutputDevice.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "Engine/World.h"
+
+namespace FGCorrectionTelemetry
+{
+	static const float PredictionErrorBounds[FFGCorrectionHistogram::NumBuckets - 1] = { 5.0f, 10.0f, 20.0f, 40.0f, 80.0f, 160.0f, 320.0f };
+	static const float TimeBetweenSnapsBounds[FFGCorrectionHistogram::NumBuckets - 1] = { 0.1f, 0.25f, 0.5f, 1.0f, 2.0f, 5.0f, 10.0f };
+	static const float CrumbDepthBounds[FFGCorrectionHistogram::NumBuckets - 1] = { 0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 6.0f, 8.0f };
+
+	// The lock only guards the player list, counters are written without it
+	static FCriticalSection PlayersLock;
+	static TArray<TSharedPtr<FFGPlayerCorrectionTelemetry, ESPMode::ThreadSafe>> Players;
+	static FFGCorrectionHistogram CrumbDepth(CrumbDepthBounds);
+	static FDelegateHandle WorldCleanupHandle;
+
+	static void OnWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources)
+	{
+		if (World == nullptr || !World->IsGameWorld())
+		{
+			return;
+		}
+
+		if (World->GetNetMode() != NM_Standalone)
+		{
+			bool bHasData = CrumbDepth.GetTotalCount() > 0;
+			{
+				FScopeLock Lock(&PlayersLock);
+				for (const TSharedPtr<FFGPlayerCorrectionTelemetry, ESPMode::ThreadSafe>& Player : Players)
+				{
+					bHasData |= Player->NumUpdates.Load(EMemoryOrder::Relaxed) > 0;
+				}
+			}
+
+			if (bHasData)
+			{
+				const FString FileName = FString::Printf(TEXT("Corrections_%s_%s.csv"), World->GetNetMode() == NM_Client ? TEXT("Client") : TEXT("Server"), *FDateTime::Now().ToString());
+				FFGCorrectionTelemetry::Export(FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Telemetry"), FileName));
+			}
+		}
+
+		// Players have ended play by now, their telemetry was only kept around for the export
+		FScopeLock Lock(&PlayersLock);
+		Players.RemoveAll([](const TSharedPtr<FFGPlayerCorrectionTelemetry, ESPMode::ThreadSafe>& Player) { return Player->bUnregistered; });
+	}
+
+	static FAutoConsoleCommandWithOutputDevice DumpCommand(
+		TEXT("FGNet.Corrections.Dump"),
+		TEXT("Prints movement correction counters and histograms for every player"),
+		FConsoleCommandWithOutputDeviceDelegate::CreateStatic(&FFGCorrectionTelemetry::Dump));
+
+	static FAutoConsoleCommand ResetCommand(
+		TEXT("FGNet.Corrections.Reset"),
+		TEXT("Clears movement correction counters and histograms"),
+		FConsoleCommandDelegate::CreateStatic(&FFGCorrectionTelemetry::Reset));
+
+	static FAutoConsoleCommand ExportCommand(
+		TEXT("FGNet.Corrections.Export"),
+		TEXT("Writes movement correction telemetry to a CSV file. Usage: FGNet.Corrections.Export [FilePath]"),
+		FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			const FString FilePath = Args.Num() > 0 ? Args[0] : FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Telemetry"), FString::Printf(TEXT("Corrections_%s.csv"), *FDateTime::Now().ToString()));
+			FFGCorrectionTelemetry::Export(FilePath);
+		}));
+}
+
+FFGCorrectionHistogram::FFGCorrectionHistogram(const float (&InUpperBounds)[NumBuckets - 1])
+{
+	for (int32 Index = 0; Index < NumBuckets - 1; ++Index)
+	{
+		UpperBounds[Index] = InUpperBounds[Index];
+	}
+
+	Reset();
+}
+
+void FFGCorrectionHistogram::Add(float Value)
+{
+	int32 Bucket = 0;
+	while (Bucket < NumBuckets - 1 && Value > UpperBounds[Bucket])
+	{
+		Bucket++;
+	}
+
+	Counts[Bucket].IncrementExchange();
+}
+
+void FFGCorrectionHistogram::Reset()
+{
+	for (TAtomic<int32>& Count : Counts)
+	{
+		Count.Store(0, EMemoryOrder::Relaxed);
+	}
+}
+
+int32 FFGCorrectionHistogram::GetTotalCount() const
+{
+	int32 Total = 0;
+	for (int32 Bucket = 0; Bucket < NumBuckets; ++Bucket)
+	{
+		Total += GetCount(Bucket);
+	}
+
+	return Total;
+}
+
+FString FFGCorrectionHistogram::GetBucketName(int32 Bucket) const
+{
+	if (Bucket == NumBuckets - 1)
+	{
+		return FString::Printf(TEXT(">%g"), UpperBounds[NumBuckets - 2]);
+	}
+
+	return FString::Printf(TEXT("<=%g"), UpperBounds[Bucket]);
+}
+
+FString FFGCorrectionHistogram::ToString() const
+{
+	FString Result;
+	for (int32 Bucket = 0; Bucket < NumBuckets; ++Bucket)
+	{
+		Result += FString::Printf(TEXT("%s%s: %d"), Bucket > 0 ? TEXT(", ") : TEXT(""), *GetBucketName(Bucket), GetCount(Bucket));
+	}
+
+	return Result;
+}
+
+FFGPlayerCorrectionTelemetry::FFGPlayerCorrectionTelemetry()
+	: PredictionError(FGCorrectionTelemetry::PredictionErrorBounds)
+	, TimeBetweenSnaps(FGCorrectionTelemetry::TimeBetweenSnapsBounds)
+{
+}
+
+void FFGPlayerCorrectionTelemetry::Reset()
+{
+	NumUpdates.Store(0, EMemoryOrder::Relaxed);
+	NumSnaps.Store(0, EMemoryOrder::Relaxed);
+	LastSnapTime = -1.0;
+	PredictionError.Reset();
+	TimeBetweenSnaps.Reset();
+}
+
+void FFGCorrectionTelemetry::Startup()
+{
+	FGCorrectionTelemetry::WorldCleanupHandle = FWorldDelegates::OnWorldCleanup.AddStatic(&FGCorrectionTelemetry::OnWorldCleanup);
+}
+
+void FFGCorrectionTelemetry::Shutdown()
+{
+	FWorldDelegates::OnWorldCleanup.Remove(FGCorrectionTelemetry::WorldCleanupHandle);
+}
+
+TSharedRef<FFGPlayerCorrectionTelemetry, ESPMode::ThreadSafe> FFGCorrectionTelemetry::RegisterPlayer(const FString& PlayerName)
+{
+	TSharedRef<FFGPlayerCorrectionTelemetry, ESPMode::ThreadSafe> Telemetry = MakeShared<FFGPlayerCorrectionTelemetry, ESPMode::ThreadSafe>();
+	Telemetry->PlayerName = PlayerName;
+
+	FScopeLock Lock(&FGCorrectionTelemetry::PlayersLock);
+	FGCorrectionTelemetry::Players.Add(Telemetry);
+	return Telemetry;
+}
+
+void FFGCorrectionTelemetry::UnregisterPlayer(const TSharedPtr<FFGPlayerCorrectionTelemetry, ESPMode::ThreadSafe>& Telemetry)
+{
+	if (Telemetry.IsValid())
+	{
+		FScopeLock Lock(&FGCorrectionTelemetry::PlayersLock);
+		Telemetry->bUnregistered = true;
+	}
+}
+
+void FFGCorrectionTelemetry::RecordMovementUpdate(FFGPlayerCorrectionTelemetry& Telemetry, float PredictionError, bool bSnapped, double CurrentTime)
+{
+	Telemetry.NumUpdates.IncrementExchange();
+	Telemetry.PredictionError.Add(PredictionError);
+	SET_FLOAT_STAT(STAT_FGLastPredictionError, PredictionError);
+	INC_DWORD_STAT(STAT_FGMovementUpdates);
+
+	if (bSnapped)
+	{
+		Telemetry.NumSnaps.IncrementExchange();
+		INC_DWORD_STAT(STAT_FGMovementSnaps);
+
+		if (Telemetry.LastSnapTime >= 0.0)
+		{
+			Telemetry.TimeBetweenSnaps.Add(static_cast<float>(CurrentTime - Telemetry.LastSnapTime));
+		}
+
+		Telemetry.LastSnapTime = CurrentTime;
+	}
+}
+
+void FFGCorrectionTelemetry::RecordCrumbTrailDepth(int32 NumCrumbs)
+{
+	FGCorrectionTelemetry::CrumbDepth.Add(static_cast<float>(NumCrumbs));
+	SET_DWORD_STAT(STAT_FGCrumbTrailDepth, NumCrumbs);
+}
+
+int32 FFGCorrectionTelemetry::GetTotalSnaps()
+{
+	FScopeLock Lock(&FGCorrectionTelemetry::PlayersLock);
+
+	int32 TotalSnaps = 0;
+	for (const TSharedPtr<FFGPlayerCorrectionTelemetry, ESPMode::ThreadSafe>& Player : FGCorrectionTelemetry::Players)
+	{
+		TotalSnaps += Player->NumSnaps.Load(EMemoryOrder::Relaxed);
+	}
+
+	return TotalSnaps;
+}
+
+void FFGCorrectionTelemetry::Dump(FOutputDevice& Ar)
+{
+	FScopeLock Lock(&FGCorrectionTelemetry::PlayersLock);
+
+	for (const TSharedPtr<FFGPlayerCorrectionTelemetry, ESPMode::ThreadSafe>& Player : FGCorrectionTelemetry::Players)
+	{
+		const int32 NumUpdates = Player->NumUpdates.Load(EMemoryOrder::Relaxed);
+		const int32 NumSnaps = Player->NumSnaps.Load(EMemoryOrder::Relaxed);
+
+		Ar.Logf(TEXT("%s: %d updates, %d snaps (%.1f%%)"), *Player->PlayerName, NumUpdates, NumSnaps, NumUpdates > 0 ? 100.0f * NumSnaps / NumUpdates : 0.0f);
+		Ar.Logf(TEXT("  Prediction error (cm): %s"), *Player->PredictionError.ToString());
+		Ar.Logf(TEXT("  Time between snaps (s): %s"), *Player->TimeBetweenSnaps.ToString());
+	}
+
+	Ar.Logf(TEXT("Crumb trail depth: %s"), *FGCorrectionTelemetry::CrumbDepth.ToString());
+}
+
+void FFGCorrectionTelemetry::Reset()
+{
+	FScopeLock Lock(&FGCorrectionTelemetry::PlayersLock);
+
+	for (const TSharedPtr<FFGPlayerCorrectionTelemetry, ESPMode::ThreadSafe>& Player : FGCorrectionTelemetry::Players)
+	{
+		Player->Reset();
+	}
+
+	FGCorrectionTelemetry::CrumbDepth.Reset();
+	SET_DWORD_STAT(STAT_FGMovementUpdates, 0);
+	SET_DWORD_STAT(STAT_FGMovementSnaps, 0);
+}
+
+bool FFGCorrectionTelemetry::Export(const FString& FilePath)
+{
+	// One row per player and histogram, so the file can be pivoted on any column
+	FString Csv = TEXT("Player,Histogram,Updates,Snaps");
+	for (int32 Bucket = 0; Bucket < FFGCorrectionHistogram::NumBuckets; ++Bucket)
+	{
+		Csv += FString::Printf(TEXT(",Bucket%d"), Bucket);
+	}
+	Csv += LINE_TERMINATOR;
+
+	auto AppendRow = [&Csv](const FString& PlayerName, const TCHAR* HistogramName, int32 NumUpdates, int32 NumSnaps, const FFGCorrectionHistogram& Histogram)
+	{
+		Csv += FString::Printf(TEXT("%s,%s,%d,%d"), *PlayerName, HistogramName, NumUpdates, NumSnaps);
+		for (int32 Bucket = 0; Bucket < FFGCorrectionHistogram::NumBuckets; ++Bucket)
+		{
+			Csv += FString::Printf(TEXT(",%d"), Histogram.GetCount(Bucket));
+		}
+		Csv += LINE_TERMINATOR;
+	};
+
+	// Bucket bounds so the columns can be read without the source
+	auto AppendBoundsRow = [&Csv](const TCHAR* HistogramName, const FFGCorrectionHistogram& Histogram)
+	{
+		Csv += FString::Printf(TEXT("#Bounds,%s,,"), HistogramName);
+		for (int32 Bucket = 0; Bucket < FFGCorrectionHistogram::NumBuckets; ++Bucket)
+		{
+			Csv += TEXT(",") + Histogram.GetBucketName(Bucket);
+		}
+		Csv += LINE_TERMINATOR;
+	};
+
+	AppendBoundsRow(TEXT("PredictionError"), FFGCorrectionHistogram(FGCorrectionTelemetry::PredictionErrorBounds));
+	AppendBoundsRow(TEXT("TimeBetweenSnaps"), FFGCorrectionHistogram(FGCorrectionTelemetry::TimeBetweenSnapsBounds));
+	AppendBoundsRow(TEXT("CrumbTrailDepth"), FGCorrectionTelemetry::CrumbDepth);
+
+	{
+		FScopeLock Lock(&FGCorrectionTelemetry::PlayersLock);
+
+		for (const TSharedPtr<FFGPlayerCorrectionTelemetry, ESPMode::ThreadSafe>& Player : FGCorrectionTelemetry::Players)
+		{
+			const int32 NumUpdates = Player->NumUpdates.Load(EMemoryOrder::Relaxed);
+			const int32 NumSnaps = Player->NumSnaps.Load(EMemoryOrder::Relaxed);
+			AppendRow(Player->PlayerName, TEXT("PredictionError"), NumUpdates, NumSnaps, Player->PredictionError);
+			AppendRow(Player->PlayerName, TEXT("TimeBetweenSnaps"), NumUpdates, NumSnaps, Player->TimeBetweenSnaps);
+		}
+	}
+
+	AppendRow(TEXT("All"), TEXT("CrumbTrailDepth"), 0, 0, FGCorrectionTelemetry::CrumbDepth);
+
+	if (!FFileHelper::SaveStringToFile(Csv, *FilePath))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("FGNet: Failed to export correction telemetry to %s"), *FilePath);
+		return false;
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("FGNet: Exported correction telemetry to %s"), *FilePath);
+	return true;
+}
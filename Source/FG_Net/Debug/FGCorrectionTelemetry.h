@@ -0,0 +1,69 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/Atomic.h"
+
+// Fixed-bucket histogram that can be written from any thread without locking.
+// The last bucket collects everything above the highest bound.
+class FG_NET_API FFGCorrectionHistogram
+{
+public:
+	static constexpr int32 NumBuckets = 8;
+
+	explicit FFGCorrectionHistogram(const float (&InUpperBounds)[NumBuckets - 1]);
+
+	void Add(float Value);
+	void Reset();
+
+	int32 GetCount(int32 Bucket) const { return Counts[Bucket].Load(EMemoryOrder::Relaxed); }
+	int32 GetTotalCount() const;
+	FString GetBucketName(int32 Bucket) const;
+	FString ToString() const;
+
+private:
+	float UpperBounds[NumBuckets - 1];
+	TAtomic<int32> Counts[NumBuckets];
+};
+
+// Movement correction counters for a single player
+struct FG_NET_API FFGPlayerCorrectionTelemetry
+{
+	FFGPlayerCorrectionTelemetry();
+
+	FString PlayerName;
+	TAtomic<int32> NumUpdates { 0 };
+	TAtomic<int32> NumSnaps { 0 };
+	double LastSnapTime = -1.0;
+	// Set when the player ends play, the entry is dropped after the world cleanup export
+	bool bUnregistered = false;
+
+	// Distance in cm between the predicted and the received location
+	FFGCorrectionHistogram PredictionError;
+	// Seconds between two snaps
+	FFGCorrectionHistogram TimeBetweenSnaps;
+
+	void Reset();
+};
+
+// Keeps track of all players' correction telemetry, together with the crumb trail depth of smoothed value replicators.
+// Dumped with FGNet.Corrections.Dump, cleared with FGNet.Corrections.Reset and exported to Saved/Telemetry when the game world is torn down.
+class FG_NET_API FFGCorrectionTelemetry
+{
+public:
+	static void Startup();
+	static void Shutdown();
+
+	static TSharedRef<FFGPlayerCorrectionTelemetry, ESPMode::ThreadSafe> RegisterPlayer(const FString& PlayerName);
+	// Keeps the player's counters until the world is cleaned up so the match end export still includes them
+	static void UnregisterPlayer(const TSharedPtr<FFGPlayerCorrectionTelemetry, ESPMode::ThreadSafe>& Telemetry);
+
+	static void RecordMovementUpdate(FFGPlayerCorrectionTelemetry& Telemetry, float PredictionError, bool bSnapped, double CurrentTime);
+	static void RecordCrumbTrailDepth(int32 NumCrumbs);
+
+	// Snaps across all players since the last reset
+	static int32 GetTotalSnaps();
+
+	static void Dump(FOutputDevice& Ar);
+	static void Reset();
+	static bool Export(const FString& FilePath);
+};
@@ -0,0 +1,218 @@
+#include "FGLoadTestRecorder.h"
+#include "FGNetStats.h"
+#include "Engine/NetDriver.h"
+#include "Engine/NetConnection.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/PlatformMemory.h"
+
+namespace FGLoadTest
+{
+	struct FConnectionBandwidth
+	{
+		int64 TotalInBytesPerSecond = 0;
+		int64 TotalOutBytesPerSecond = 0;
+		int32 MaxInBytesPerSecond = 0;
+		int32 MaxOutBytesPerSecond = 0;
+		int32 NumSamples = 0;
+	};
+
+	static bool bInitialized = false;
+	static bool bEnabled = false;
+	static bool bReportWritten = false;
+	static double Duration = 0.0;
+	static double ElapsedTime = 0.0;
+	static double TimeUntilConnectionSample = 1.0;
+	static int32 NumCorrections = 0;
+	static int32 PeakConnections = 0;
+	static double StartupSeconds = 0.0;
+	static uint64 BaselineUsedPhysical = 0;
+	static uint64 PeakUsedPhysical = 0;
+	static TArray<float> FrameTimesMs;
+	static TMap<FString, FConnectionBandwidth> Bandwidth;
+
+	static float GetPercentile(const TArray<float>& SortedValues, float Percentile)
+	{
+		if (SortedValues.Num() == 0)
+		{
+			return 0.0f;
+		}
+
+		const int32 Index = FMath::Clamp(FMath::CeilToInt(Percentile * SortedValues.Num()) - 1, 0, SortedValues.Num() - 1);
+		return SortedValues[Index];
+	}
+}
+
+bool FFGLoadTestRecorder::IsEnabled()
+{
+	Initialize();
+	return FGLoadTest::bEnabled;
+}
+
+void FFGLoadTestRecorder::NotifyCorrection()
+{
+	if (IsEnabled())
+	{
+		FGLoadTest::NumCorrections++;
+	}
+}
+
+void FFGLoadTestRecorder::Initialize()
+{
+	if (FGLoadTest::bInitialized)
+	{
+		return;
+	}
+
+	FGLoadTest::bInitialized = true;
+	FGLoadTest::bEnabled = FParse::Param(FCommandLine::Get(), TEXT("FGLoadTest"));
+	FParse::Value(FCommandLine::Get(), TEXT("FGLoadTestDuration="), FGLoadTest::Duration);
+
+	if (FGLoadTest::bEnabled)
+	{
+		// Roughly ten minutes at 60 frames per second
+		FGLoadTest::FrameTimesMs.Reserve(36000);
+	}
+}
+
+void FFGLoadTestRecorder::Tick(float DeltaTime)
+{
+	if (!IsEnabled() || FGLoadTest::bReportWritten)
+	{
+		return;
+	}
+
+	// Skip frames before the game world is up, they are dominated by loading
+	if (FFGNetStats::FindGameNetDriver() == nullptr)
+	{
+		return;
+	}
+
+	if (FGLoadTest::FrameTimesMs.Num() == 0)
+	{
+		// Memory in use before anyone has joined, so the growth can be divided between the connections
+		FGLoadTest::StartupSeconds = FPlatformTime::Seconds() - GStartTime;
+		FGLoadTest::BaselineUsedPhysical = FPlatformMemory::GetStats().UsedPhysical;
+		FGLoadTest::PeakUsedPhysical = FGLoadTest::BaselineUsedPhysical;
+	}
+
+	FGLoadTest::ElapsedTime += DeltaTime;
+	FGLoadTest::FrameTimesMs.Add(FPlatformTime::ToMilliseconds(GGameThreadTime));
+
+	FGLoadTest::TimeUntilConnectionSample -= DeltaTime;
+	if (FGLoadTest::TimeUntilConnectionSample <= 0.0)
+	{
+		FGLoadTest::TimeUntilConnectionSample += 1.0;
+		SampleConnections();
+	}
+
+	if (FGLoadTest::Duration > 0.0 && FGLoadTest::ElapsedTime >= FGLoadTest::Duration)
+	{
+		WriteReport();
+		FPlatformMisc::RequestExit(false);
+	}
+}
+
+void FFGLoadTestRecorder::Shutdown()
+{
+	if (IsEnabled() && !FGLoadTest::bReportWritten)
+	{
+		WriteReport();
+	}
+}
+
+void FFGLoadTestRecorder::SampleConnections()
+{
+	UNetDriver* NetDriver = FFGNetStats::FindGameNetDriver();
+
+	TArray<UNetConnection*> Connections;
+	if (NetDriver->ServerConnection != nullptr)
+	{
+		Connections.Add(NetDriver->ServerConnection);
+	}
+
+	Connections.Append(NetDriver->ClientConnections);
+	FGLoadTest::PeakConnections = FMath::Max(FGLoadTest::PeakConnections, NetDriver->ClientConnections.Num());
+	FGLoadTest::PeakUsedPhysical = FMath::Max<uint64>(FGLoadTest::PeakUsedPhysical, FPlatformMemory::GetStats().UsedPhysical);
+
+	for (UNetConnection* Connection : Connections)
+	{
+		if (Connection == nullptr)
+		{
+			continue;
+		}
+
+		FGLoadTest::FConnectionBandwidth& Sample = FGLoadTest::Bandwidth.FindOrAdd(Connection->LowLevelGetRemoteAddress(true));
+		Sample.TotalInBytesPerSecond += Connection->InBytesPerSecond;
+		Sample.TotalOutBytesPerSecond += Connection->OutBytesPerSecond;
+		Sample.MaxInBytesPerSecond = FMath::Max(Sample.MaxInBytesPerSecond, Connection->InBytesPerSecond);
+		Sample.MaxOutBytesPerSecond = FMath::Max(Sample.MaxOutBytesPerSecond, Connection->OutBytesPerSecond);
+		Sample.NumSamples++;
+	}
+}
+
+void FFGLoadTestRecorder::WriteReport()
+{
+	FGLoadTest::bReportWritten = true;
+
+	TArray<float> SortedFrameTimes = FGLoadTest::FrameTimesMs;
+	SortedFrameTimes.Sort();
+
+	const bool bIsServer = IsRunningDedicatedServer();
+	const uint64 MemoryGrowth = FGLoadTest::PeakUsedPhysical - FMath::Min(FGLoadTest::BaselineUsedPhysical, FGLoadTest::PeakUsedPhysical);
+
+	FString Report = TEXT("{\n");
+	Report += FString::Printf(TEXT("\t\"Role\": \"%s\",\n"), bIsServer ? TEXT("Server") : TEXT("Client"));
+	Report += FString::Printf(TEXT("\t\"Duration\": %.2f,\n"), FGLoadTest::ElapsedTime);
+	Report += FString::Printf(TEXT("\t\"Frames\": %d,\n"), SortedFrameTimes.Num());
+	Report += FString::Printf(TEXT("\t\"PeakConnections\": %d,\n"), FGLoadTest::PeakConnections);
+	Report += FString::Printf(TEXT("\t\"Corrections\": %d,\n"), FGLoadTest::NumCorrections);
+	Report += FString::Printf(TEXT("\t\"StartupSeconds\": %.2f,\n"), FGLoadTest::StartupSeconds);
+	Report += FString::Printf(TEXT("\t\"MemoryMB\": { \"Baseline\": %.1f, \"Peak\": %.1f, \"PerConnection\": %.2f },\n"),
+		FGLoadTest::BaselineUsedPhysical / (1024.0 * 1024.0),
+		FGLoadTest::PeakUsedPhysical / (1024.0 * 1024.0),
+		MemoryGrowth / (1024.0 * 1024.0) / FMath::Max(FGLoadTest::PeakConnections, 1));
+	Report += FString::Printf(TEXT("\t\"TickTimeMs\": { \"P50\": %.3f, \"P90\": %.3f, \"P99\": %.3f, \"Max\": %.3f },\n"),
+		FGLoadTest::GetPercentile(SortedFrameTimes, 0.5f),
+		FGLoadTest::GetPercentile(SortedFrameTimes, 0.9f),
+		FGLoadTest::GetPercentile(SortedFrameTimes, 0.99f),
+		FGLoadTest::GetPercentile(SortedFrameTimes, 1.0f));
+	Report += TEXT("\t\"Connections\": [\n");
+
+	int32 ConnectionIndex = 0;
+	for (const TPair<FString, FGLoadTest::FConnectionBandwidth>& Pair : FGLoadTest::Bandwidth)
+	{
+		const FGLoadTest::FConnectionBandwidth& Sample = Pair.Value;
+		const int32 NumSamples = FMath::Max(Sample.NumSamples, 1);
+		Report += FString::Printf(TEXT("\t\t{ \"Address\": \"%s\", \"AvgInBytesPerSecond\": %lld, \"AvgOutBytesPerSecond\": %lld, \"MaxInBytesPerSecond\": %d, \"MaxOutBytesPerSecond\": %d }%s\n"),
+			*Pair.Key,
+			Sample.TotalInBytesPerSecond / NumSamples,
+			Sample.TotalOutBytesPerSecond / NumSamples,
+			Sample.MaxInBytesPerSecond,
+			Sample.MaxOutBytesPerSecond,
+			++ConnectionIndex < FGLoadTest::Bandwidth.Num() ? TEXT(",") : TEXT(""));
+	}
+
+	Report += TEXT("\t]\n}\n");
+
+	FString ReportDir;
+	if (!FParse::Value(FCommandLine::Get(), TEXT("FGLoadTestReportDir="), ReportDir))
+	{
+		ReportDir = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("LoadTest"));
+	}
+
+	const FString ReportPath = FPaths::Combine(ReportDir, FString::Printf(TEXT("%s_%u.json"), bIsServer ? TEXT("Server") : TEXT("Client"), FPlatformProcess::GetCurrentProcessId()));
+
+	if (FFileHelper::SaveStringToFile(Report, *ReportPath))
+	{
+		UE_LOG(LogTemp, Display, TEXT("FGLoadTest: Wrote report to %s"), *ReportPath);
+	}
+	else
+	{
+		UE_LOG(LogTemp, Warning, TEXT("FGLoadTest: Failed to write report to %s"), *ReportPath);
+	}
+}
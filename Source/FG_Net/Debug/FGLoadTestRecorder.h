@@ -0,0 +1,19 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Collects tick time, per-connection bandwidth, memory, startup time and correction counts while running with -FGLoadTest.
+// The report is written to Saved/LoadTest (or -FGLoadTestReportDir=) when -FGLoadTestDuration= has elapsed or on shutdown.
+class FG_NET_API FFGLoadTestRecorder
+{
+public:
+	static bool IsEnabled();
+	static void NotifyCorrection();
+	static void Tick(float DeltaTime);
+	static void Shutdown();
+
+private:
+	static void Initialize();
+	static void SampleConnections();
+	static void WriteReport();
+};
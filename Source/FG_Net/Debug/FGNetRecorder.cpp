@@ -0,0 +1,308 @@
+#include "FGNetRecorder.h"
+#include "FGNetStats.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "HAL/PlatformFilemanager.h"
+#include "GenericPlatform/GenericPlatformFile.h"
+#include "Misc/Paths.h"
+#include "HAL/Event.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "Containers/Queue.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+#include "Serialization/MemoryWriter.h"
+#include "../Player/FGPlayer.h"
+
+namespace FGNetRecorder
+{
+	// Buffers are handed to the writer thread when they reach this size, or every FlushInterval seconds
+	static const int32 FlushSize = 64 * 1024;
+	static const float FlushInterval = 0.5f;
+
+	class FWriter : public FRunnable
+	{
+	public:
+		explicit FWriter(IFileHandle* InFileHandle)
+			: FileHandle(InFileHandle)
+		{
+			WorkEvent = FPlatformProcess::GetSynchEventFromPool();
+			Thread = FRunnableThread::Create(this, TEXT("FGNetRecordWriter"), 0, TPri_BelowNormal);
+		}
+
+		virtual ~FWriter()
+		{
+			bStopping = true;
+			WorkEvent->Trigger();
+			Thread->WaitForCompletion();
+			delete Thread;
+			FPlatformProcess::ReturnSynchEventToPool(WorkEvent);
+		}
+
+		void Enqueue(TArray<uint8>&& Buffer)
+		{
+			PendingBuffers.Enqueue(MoveTemp(Buffer));
+			WorkEvent->Trigger();
+		}
+
+		virtual uint32 Run() override
+		{
+			while (!bStopping)
+			{
+				WorkEvent->Wait();
+				WritePending();
+			}
+
+			WritePending();
+			FileHandle->Flush();
+			return 0;
+		}
+
+	private:
+		void WritePending()
+		{
+			TArray<uint8> Buffer;
+			while (PendingBuffers.Dequeue(Buffer))
+			{
+				FileHandle->Write(Buffer.GetData(), Buffer.Num());
+			}
+		}
+
+		TUniquePtr<IFileHandle> FileHandle;
+		TQueue<TArray<uint8>, EQueueMode::Spsc> PendingBuffers;
+		FEvent* WorkEvent = nullptr;
+		FRunnableThread* Thread = nullptr;
+		TAtomic<bool> bStopping { false };
+	};
+
+	static bool bCheckedCommandLine = false;
+	static TUniquePtr<FWriter> Writer;
+	static TArray<uint8> Buffer;
+	static float TimeUntilFlush = FlushInterval;
+	static double StartTime = -1.0;
+	static TMap<TWeakObjectPtr<const AFGPlayer>, uint16> PlayerIds;
+	static TMap<FName, uint16> NameIds;
+
+	static void BeginRecord(FArchive& Ar, FGNetRecord::EType Type, const UObject& WorldContext)
+	{
+		const double WorldTime = WorldContext.GetWorld()->GetTimeSeconds();
+		if (StartTime < 0.0)
+		{
+			StartTime = WorldTime;
+		}
+
+		uint8 TypeValue = static_cast<uint8>(Type);
+		float Time = static_cast<float>(WorldTime - StartTime);
+		Ar << TypeValue;
+		Ar << Time;
+	}
+
+	static void EndRecord()
+	{
+		if (Buffer.Num() >= FlushSize)
+		{
+			Writer->Enqueue(MoveTemp(Buffer));
+			Buffer.Reset(FlushSize);
+		}
+	}
+
+	static uint16 GetPlayerId(const AFGPlayer& Player)
+	{
+		if (const uint16* ExistingId = PlayerIds.Find(&Player))
+		{
+			return *ExistingId;
+		}
+
+		uint16 PlayerId = static_cast<uint16>(PlayerIds.Num());
+		PlayerIds.Add(&Player, PlayerId);
+
+		FVector Location = Player.GetActorLocation();
+		FRotator Rotation = Player.GetActorRotation();
+		FMemoryWriter Ar(Buffer, false, true);
+		BeginRecord(Ar, FGNetRecord::EType::Player, Player);
+		Ar << PlayerId;
+		Ar << Location;
+		Ar << Rotation;
+		return PlayerId;
+	}
+
+	static uint16 GetNameId(FName Name, const UObject& WorldContext)
+	{
+		if (const uint16* ExistingId = NameIds.Find(Name))
+		{
+			return *ExistingId;
+		}
+
+		uint16 NameId = static_cast<uint16>(NameIds.Num());
+		NameIds.Add(Name, NameId);
+
+		FString NameString = Name.ToString();
+		FMemoryWriter Ar(Buffer, false, true);
+		BeginRecord(Ar, FGNetRecord::EType::Name, WorldContext);
+		Ar << NameId;
+		Ar << NameString;
+		return NameId;
+	}
+}
+
+bool FFGNetRecorder::IsRecording()
+{
+	return FGNetRecorder::Writer.IsValid();
+}
+
+bool FFGNetRecorder::Start(const FString& FilePath)
+{
+	Stop();
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	PlatformFile.CreateDirectoryTree(*FPaths::GetPath(FilePath));
+
+	IFileHandle* FileHandle = PlatformFile.OpenWrite(*FilePath);
+	if (FileHandle == nullptr)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("FGNetRecorder: Could not open %s for writing"), *FilePath);
+		return false;
+	}
+
+	FGNetRecorder::Buffer.Reset(FGNetRecorder::FlushSize);
+	FGNetRecorder::StartTime = -1.0;
+	FGNetRecorder::PlayerIds.Reset();
+	FGNetRecorder::NameIds.Reset();
+
+	FMemoryWriter Ar(FGNetRecorder::Buffer, false, true);
+	uint32 Magic = FGNetRecord::Magic;
+	uint32 Version = FGNetRecord::Version;
+	Ar << Magic;
+	Ar << Version;
+
+	FGNetRecorder::Writer = MakeUnique<FGNetRecorder::FWriter>(FileHandle);
+
+	UE_LOG(LogTemp, Display, TEXT("FGNetRecorder: Recording to %s"), *FilePath);
+	return true;
+}
+
+void FFGNetRecorder::Stop()
+{
+	if (!IsRecording())
+	{
+		return;
+	}
+
+	if (FGNetRecorder::Buffer.Num() > 0)
+	{
+		FGNetRecorder::Writer->Enqueue(MoveTemp(FGNetRecorder::Buffer));
+	}
+
+	// Waits for the writer thread to drain its queue
+	FGNetRecorder::Writer.Reset();
+	FGNetRecorder::Buffer.Empty();
+	FGNetRecorder::PlayerIds.Empty();
+	FGNetRecorder::NameIds.Empty();
+}
+
+void FFGNetRecorder::Tick(float DeltaTime)
+{
+	if (!FGNetRecorder::bCheckedCommandLine)
+	{
+		FString FilePath;
+		if (!FParse::Value(FCommandLine::Get(), TEXT("FGRecord="), FilePath))
+		{
+			FGNetRecorder::bCheckedCommandLine = true;
+			return;
+		}
+
+		// Only the server receives the RPCs, so wait until it is listening
+		UNetDriver* NetDriver = FFGNetStats::FindGameNetDriver();
+		if (NetDriver != nullptr && NetDriver->IsServer())
+		{
+			FGNetRecorder::bCheckedCommandLine = true;
+			Start(FilePath);
+		}
+	}
+
+	if (!IsRecording())
+	{
+		return;
+	}
+
+	FGNetRecorder::TimeUntilFlush -= DeltaTime;
+	if (FGNetRecorder::TimeUntilFlush <= 0.0f)
+	{
+		FGNetRecorder::TimeUntilFlush = FGNetRecorder::FlushInterval;
+
+		if (FGNetRecorder::Buffer.Num() > 0)
+		{
+			FGNetRecorder::Writer->Enqueue(MoveTemp(FGNetRecorder::Buffer));
+			FGNetRecorder::Buffer.Reset(FGNetRecorder::FlushSize);
+		}
+	}
+}
+
+void FFGNetRecorder::RecordMovement(const AFGPlayer& Player, const FVector& Location, uint32 TimeStamp, float Velocity, float Forward, float Turn, uint8 Yaw, bool bBrake)
+{
+	if (!IsRecording())
+	{
+		return;
+	}
+
+	uint16 PlayerId = FGNetRecorder::GetPlayerId(Player);
+	FVector RecordedLocation = Location;
+	uint8 RecordedBrake = bBrake ? 1 : 0;
+
+	FMemoryWriter Ar(FGNetRecorder::Buffer, false, true);
+	FGNetRecorder::BeginRecord(Ar, FGNetRecord::EType::Movement, Player);
+	Ar << PlayerId;
+	Ar << RecordedLocation;
+	Ar << TimeStamp;
+	Ar << Velocity;
+	Ar << Forward;
+	Ar << Turn;
+	Ar << Yaw;
+	Ar << RecordedBrake;
+	FGNetRecorder::EndRecord();
+}
+
+void FFGNetRecorder::RecordFire(const AFGPlayer& Player, const FVector& Location, const FRotator& Rotation)
+{
+	if (!IsRecording())
+	{
+		return;
+	}
+
+	uint16 PlayerId = FGNetRecorder::GetPlayerId(Player);
+	FVector RecordedLocation = Location;
+	FRotator RecordedRotation = Rotation;
+
+	FMemoryWriter Ar(FGNetRecorder::Buffer, false, true);
+	FGNetRecorder::BeginRecord(Ar, FGNetRecord::EType::Fire, Player);
+	Ar << PlayerId;
+	Ar << RecordedLocation;
+	Ar << RecordedRotation;
+	FGNetRecorder::EndRecord();
+}
+
+void FFGNetRecorder::RecordReplicatorValue(const UObject& Replicator, int32 SyncTag, float Value, bool bIsTerminal)
+{
+	if (!IsRecording())
+	{
+		return;
+	}
+
+	// Replicators are named subobjects of their actor, players are referred to by id since their names differ between runs
+	const UObject* Owner = Replicator.GetOuter();
+	const AFGPlayer* OwnerPlayer = Cast<AFGPlayer>(Owner);
+	uint16 OwnerPlayerId = OwnerPlayer != nullptr ? FGNetRecorder::GetPlayerId(*OwnerPlayer) : FGNetRecord::InvalidId;
+	uint16 OwnerNameId = OwnerPlayer == nullptr ? FGNetRecorder::GetNameId(Owner->GetFName(), Replicator) : FGNetRecord::InvalidId;
+	uint16 ReplicatorNameId = FGNetRecorder::GetNameId(Replicator.GetFName(), Replicator);
+	uint8 bRecordedIsTerminal = bIsTerminal ? 1 : 0;
+
+	FMemoryWriter Ar(FGNetRecorder::Buffer, false, true);
+	FGNetRecorder::BeginRecord(Ar, FGNetRecord::EType::ReplicatorValue, Replicator);
+	Ar << OwnerPlayerId;
+	Ar << OwnerNameId;
+	Ar << ReplicatorNameId;
+	Ar << SyncTag;
+	Ar << Value;
+	Ar << bRecordedIsTerminal;
+	FGNetRecorder::EndRecord();
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class AFGPlayer;
+
+// Record layout of the files written by FFGNetRecorder and read by FFGNetReplay.
+// Every record starts with its type and the seconds since recording started.
+namespace FGNetRecord
+{
+	static const uint32 Magic = 0x524E4746; // "FGNR"
+	static const uint32 Version = 3;
+	static const uint16 InvalidId = MAX_uint16;
+
+	enum class EType : uint8
+	{
+		// uint16 NameId, FString Name
+		Name,
+		// uint16 PlayerId, FVector Location, FRotator Rotation
+		Player,
+		// uint16 PlayerId, FVector Location, uint32 TimeStamp, float Velocity, float Forward, float Turn, uint8 Yaw, uint8 bBrake
+		Movement,
+		// uint16 PlayerId, FVector Location, FRotator Rotation
+		Fire,
+		// uint16 OwnerPlayerId, uint16 OwnerNameId, uint16 ReplicatorNameId, int32 SyncTag, float Value, uint8 bIsTerminal
+		ReplicatorValue,
+	};
+}
+
+// Records incoming movement, fire and value replicator RPCs on the server when running with -FGRecord=<File>.
+// Records are gathered in memory on the game thread and handed to a background thread for writing.
+class FG_NET_API FFGNetRecorder
+{
+public:
+	static bool IsRecording();
+
+	static bool Start(const FString& FilePath);
+	static void Stop();
+	static void Tick(float DeltaTime);
+
+	static void RecordMovement(const AFGPlayer& Player, const FVector& Location, uint32 TimeStamp, float Velocity, float Forward, float Turn, uint8 Yaw, bool bBrake);
+	static void RecordFire(const AFGPlayer& Player, const FVector& Location, const FRotator& Rotation);
+	static void RecordReplicatorValue(const UObject& Replicator, int32 SyncTag, float Value, bool bIsTerminal);
+};
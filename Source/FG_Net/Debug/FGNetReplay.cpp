@@ -0,0 +1,315 @@
+#include "FGNetReplay.h"
+#include "FGNetRecorder.h"
+#include "FGNetStats.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "GameFramework/GameModeBase.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Crc.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "../Components/Replicator/FGValueReplicator.h"
+#include "../Player/FGPlayer.h"
+
+namespace FGNetReplay
+{
+	// Rockets fired at the end of the recording get this long to land before the result is taken
+	static const float SettleTime = 3.0f;
+
+	static bool bCheckedCommandLine = false;
+	static TUniquePtr<FFGNetReplay> ActiveReplay;
+}
+
+void FFGNetReplay::Tick(float DeltaTime)
+{
+	if (!FGNetReplay::bCheckedCommandLine)
+	{
+		FString ReplayPath;
+		if (!FParse::Value(FCommandLine::Get(), TEXT("FGReplay="), ReplayPath))
+		{
+			FGNetReplay::bCheckedCommandLine = true;
+			return;
+		}
+
+		// The RPC implementations expect authority, so wait for the server world
+		UNetDriver* NetDriver = FFGNetStats::FindGameNetDriver();
+		if (NetDriver == nullptr || !NetDriver->IsServer() || NetDriver->GetWorld() == nullptr || !NetDriver->GetWorld()->HasBegunPlay())
+		{
+			return;
+		}
+
+		FGNetReplay::bCheckedCommandLine = true;
+
+		TUniquePtr<FFGNetReplay> Replay = MakeUnique<FFGNetReplay>();
+		if (Replay->Load(ReplayPath))
+		{
+			FGNetReplay::ActiveReplay = MoveTemp(Replay);
+		}
+		else
+		{
+			UE_LOG(LogTemp, Warning, TEXT("FGNetReplay: Could not load %s"), *ReplayPath);
+		}
+	}
+
+	if (!FGNetReplay::ActiveReplay.IsValid())
+	{
+		return;
+	}
+
+	UNetDriver* NetDriver = FFGNetStats::FindGameNetDriver();
+	if (NetDriver != nullptr && NetDriver->GetWorld() != nullptr)
+	{
+		if (FGNetReplay::ActiveReplay->Update(*NetDriver->GetWorld(), DeltaTime))
+		{
+			FGNetReplay::ActiveReplay->Finish();
+			FGNetReplay::ActiveReplay.Reset();
+
+			if (!FParse::Param(FCommandLine::Get(), TEXT("FGReplayNoExit")))
+			{
+				FPlatformMisc::RequestExit(false);
+			}
+		}
+	}
+}
+
+bool FFGNetReplay::Load(const FString& InFilePath)
+{
+	if (!FFileHelper::LoadFileToArray(Data, *InFilePath))
+	{
+		return false;
+	}
+
+	FMemoryReader Ar(Data);
+	uint32 Magic = 0;
+	uint32 Version = 0;
+	Ar << Magic;
+	Ar << Version;
+
+	if (Ar.IsError() || Magic != FGNetRecord::Magic || Version != FGNetRecord::Version)
+	{
+		return false;
+	}
+
+	FilePath = InFilePath;
+	ReadOffset = Ar.Tell();
+	StartWallTime = FPlatformTime::Seconds();
+
+	UE_LOG(LogTemp, Display, TEXT("FGNetReplay: Replaying %s (%d bytes)"), *FilePath, Data.Num());
+	return true;
+}
+
+bool FFGNetReplay::Update(UWorld& World, float DeltaTime)
+{
+	ReplayTime += DeltaTime;
+	NumFrames++;
+
+	while (ReadOffset < Data.Num())
+	{
+		// Peek at the record time without consuming it
+		FMemoryReader Ar(Data);
+		Ar.Seek(ReadOffset + sizeof(uint8));
+		float RecordTime = 0.0f;
+		Ar << RecordTime;
+
+		if (RecordTime > ReplayTime || !ProcessRecord(World))
+		{
+			break;
+		}
+
+		TimeSinceLastRecord = 0.0f;
+	}
+
+	if (ReadOffset >= Data.Num())
+	{
+		TimeSinceLastRecord += DeltaTime;
+	}
+
+	return ReadOffset >= Data.Num() && TimeSinceLastRecord >= FGNetReplay::SettleTime;
+}
+
+bool FFGNetReplay::ProcessRecord(UWorld& World)
+{
+	FMemoryReader Ar(Data);
+	Ar.Seek(ReadOffset);
+
+	uint8 TypeValue = 0;
+	float RecordTime = 0.0f;
+	Ar << TypeValue;
+	Ar << RecordTime;
+
+	auto GetPlayer = [this](uint16 PlayerId) -> AFGPlayer*
+	{
+		return Players.IsValidIndex(PlayerId) ? Players[PlayerId].Get() : nullptr;
+	};
+
+	switch (static_cast<FGNetRecord::EType>(TypeValue))
+	{
+	case FGNetRecord::EType::Name:
+	{
+		uint16 NameId = 0;
+		FString Name;
+		Ar << NameId;
+		Ar << Name;
+		Names.SetNum(FMath::Max<int32>(Names.Num(), NameId + 1));
+		Names[NameId] = FName(*Name);
+		break;
+	}
+	case FGNetRecord::EType::Player:
+	{
+		uint16 PlayerId = 0;
+		FVector Location;
+		FRotator Rotation;
+		Ar << PlayerId;
+		Ar << Location;
+		Ar << Rotation;
+		SpawnPlayer(World, PlayerId, Location, Rotation);
+		break;
+	}
+	case FGNetRecord::EType::Movement:
+	{
+		uint16 PlayerId = 0;
+		FVector Location;
+		uint32 TimeStamp = 0;
+		float Velocity = 0.0f;
+		float Forward = 0.0f;
+		float Turn = 0.0f;
+		uint8 Yaw = 0;
+		uint8 bBrake = 0;
+		Ar << PlayerId;
+		Ar << Location;
+		Ar << TimeStamp;
+		Ar << Velocity;
+		Ar << Forward;
+		Ar << Turn;
+		Ar << Yaw;
+		Ar << bBrake;
+
+		if (AFGPlayer* Player = GetPlayer(PlayerId))
+		{
+			Player->Server_SendMovement_Implementation(Location, TimeStamp, Velocity, Forward, Turn, Yaw, bBrake != 0);
+		}
+		break;
+	}
+	case FGNetRecord::EType::Fire:
+	{
+		uint16 PlayerId = 0;
+		FVector Location;
+		FRotator Rotation;
+		Ar << PlayerId;
+		Ar << Location;
+		Ar << Rotation;
+
+		if (AFGPlayer* Player = GetPlayer(PlayerId))
+		{
+			if (AFGRocket* Rocket = Player->GetFreeRocket())
+			{
+				Player->Server_FireRocket_Implementation(Rocket, Location, Rotation.Yaw);
+			}
+		}
+		break;
+	}
+	case FGNetRecord::EType::ReplicatorValue:
+	{
+		uint16 OwnerPlayerId = 0;
+		uint16 OwnerNameId = 0;
+		uint16 ReplicatorNameId = 0;
+		int32 SyncTag = 0;
+		float Value = 0.0f;
+		uint8 bIsTerminal = 0;
+		Ar << OwnerPlayerId;
+		Ar << OwnerNameId;
+		Ar << ReplicatorNameId;
+		Ar << SyncTag;
+		Ar << Value;
+		Ar << bIsTerminal;
+
+		UObject* Owner = GetPlayer(OwnerPlayerId);
+		if (Owner == nullptr && Names.IsValidIndex(OwnerNameId))
+		{
+			Owner = StaticFindObjectFast(AActor::StaticClass(), World.PersistentLevel, Names[OwnerNameId]);
+		}
+
+		UFGValueReplicator* Replicator = Owner != nullptr && Names.IsValidIndex(ReplicatorNameId) ? FindObjectFast<UFGValueReplicator>(Owner, Names[ReplicatorNameId]) : nullptr;
+		if (Replicator != nullptr)
+		{
+			if (bIsTerminal != 0)
+			{
+				Replicator->Server_SendTerminalValue_Implementation(SyncTag, Value);
+			}
+			else
+			{
+				Replicator->Server_SendReplicatedValue_Implementation(SyncTag, Value);
+			}
+		}
+		break;
+	}
+	default:
+		UE_LOG(LogTemp, Warning, TEXT("FGNetReplay: Unknown record type %d, stopping"), TypeValue);
+		ReadOffset = Data.Num();
+		return false;
+	}
+
+	if (Ar.IsError())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("FGNetReplay: Truncated record, stopping"));
+		ReadOffset = Data.Num();
+		return false;
+	}
+
+	ReadOffset = Ar.Tell();
+	NumRecords++;
+	return true;
+}
+
+AFGPlayer* FFGNetReplay::SpawnPlayer(UWorld& World, uint16 PlayerId, const FVector& Location, const FRotator& Rotation)
+{
+	AGameModeBase* GameMode = World.GetAuthGameMode();
+	UClass* PawnClass = GameMode != nullptr ? GameMode->DefaultPawnClass : nullptr;
+
+	if (PawnClass == nullptr || !PawnClass->IsChildOf(AFGPlayer::StaticClass()))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("FGNetReplay: The game mode's default pawn is not an FGPlayer, can't replay player %d"), PlayerId);
+		return nullptr;
+	}
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+	AFGPlayer* Player = World.SpawnActor<AFGPlayer>(PawnClass, Location, Rotation, SpawnParams);
+
+	Players.SetNum(FMath::Max<int32>(Players.Num(), PlayerId + 1));
+	Players[PlayerId] = Player;
+	return Player;
+}
+
+void FFGNetReplay::Finish()
+{
+	const double WallTime = FPlatformTime::Seconds() - StartWallTime;
+
+	// Same recording and code should give the same final state, so the checksum flags behaviour changes
+	FString Result;
+	uint32 Checksum = 0;
+
+	for (int32 PlayerId = 0; PlayerId < Players.Num(); ++PlayerId)
+	{
+		const AFGPlayer* Player = Players[PlayerId].Get();
+		if (Player == nullptr)
+		{
+			continue;
+		}
+
+		const FVector Location = Player->GetActorLocation();
+		const int32 State[] = { PlayerId, FMath::RoundToInt(Location.X), FMath::RoundToInt(Location.Y), FMath::RoundToInt(Location.Z), Player->GameplayState.Health, Player->GameplayState.NumRockets };
+		Checksum = FCrc::MemCrc32(State, sizeof(State), Checksum);
+		Result += FString::Printf(TEXT("Player %d: Location %s Health %d Rockets %d\n"), PlayerId, *Location.ToCompactString(), Player->GameplayState.Health, Player->GameplayState.NumRockets);
+	}
+
+	Result = FString::Printf(TEXT("Replay: %s\nRecords: %d\nFrames: %d\nSimulated: %.2fs\nWall: %.2fs (%.1fx)\nChecksum: %08X\n"),
+		*FilePath, NumRecords, NumFrames, ReplayTime, WallTime, WallTime > 0.0 ? ReplayTime / WallTime : 0.0, Checksum) + Result;
+
+	UE_LOG(LogTemp, Display, TEXT("FGNetReplay: Finished\n%s"), *Result);
+
+	const FString ReportPath = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Replay"), FPaths::GetBaseFilename(FilePath) + TEXT("_Result.txt"));
+	FFileHelper::SaveStringToFile(Result, *ReportPath);
+}
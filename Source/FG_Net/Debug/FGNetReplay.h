@@ -0,0 +1,36 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtr.h"
+
+class AFGPlayer;
+class UWorld;
+
+// Feeds a file written by FFGNetRecorder back through the server RPC implementations, with no clients attached.
+// Run on a server with -FGReplay=<File>; add -benchmark -fps=60 to step with a fixed delta time as fast as possible.
+// When the recording has played out, timings and a checksum of the players' final state are logged and written to
+// Saved/Replay, and the process exits unless -FGReplayNoExit is given.
+class FG_NET_API FFGNetReplay
+{
+public:
+	static void Tick(float DeltaTime);
+
+private:
+	bool Load(const FString& FilePath);
+	// Returns true once the recording has played out and settled
+	bool Update(UWorld& World, float DeltaTime);
+	bool ProcessRecord(UWorld& World);
+	AFGPlayer* SpawnPlayer(UWorld& World, uint16 PlayerId, const FVector& Location, const FRotator& Rotation);
+	void Finish();
+
+	FString FilePath;
+	TArray<uint8> Data;
+	int64 ReadOffset = 0;
+	float ReplayTime = 0.0f;
+	float TimeSinceLastRecord = 0.0f;
+	int32 NumFrames = 0;
+	int32 NumRecords = 0;
+	double StartWallTime = 0.0;
+	TArray<TWeakObjectPtr<AFGPlayer>> Players;
+	TArray<FName> Names;
+};
@@ -0,0 +1,294 @@
+#include "FGNetScenario.h"
+#include "FGNetStats.h"
+#include "FGSimulatedIpConnection.h"
+#include "Engine/NetDriver.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Algo/BinarySearch.h"
+
+namespace FGNetScenario
+{
+	static bool bCheckedCommandLine = false;
+
+	static bool ParseKey(const FString& Token, const TCHAR* Key, int32& OutValue)
+	{
+		const FString Prefix = FString(Key) + TEXT("=");
+		if (!Token.StartsWith(Prefix))
+		{
+			return false;
+		}
+
+		OutValue = FMath::Max(FCString::Atoi(*Token + Prefix.Len()), 0);
+		return true;
+	}
+
+	static void GetConnections(const UNetDriver& NetDriver, TArray<UNetConnection*>& OutConnections)
+	{
+		OutConnections = NetDriver.ClientConnections;
+		if (NetDriver.ServerConnection != nullptr)
+		{
+			OutConnections.Add(NetDriver.ServerConnection);
+		}
+	}
+}
+
+FFGNetScenario& FFGNetScenario::Get()
+{
+	static FFGNetScenario Scenario;
+	return Scenario;
+}
+
+void FFGNetScenario::TickGlobal(float DeltaTime)
+{
+	FFGNetScenario& Scenario = Get();
+
+	if (!FGNetScenario::bCheckedCommandLine)
+	{
+		FGNetScenario::bCheckedCommandLine = true;
+
+		FString FilePath;
+		if (FParse::Value(FCommandLine::Get(), TEXT("FGNetScenario="), FilePath))
+		{
+			int32 ScenarioSeed = 0;
+			FParse::Value(FCommandLine::Get(), TEXT("FGNetScenarioSeed="), ScenarioSeed);
+
+			if (Scenario.LoadFromFile(FilePath))
+			{
+				Scenario.Start(ScenarioSeed);
+			}
+			else
+			{
+				UE_LOG(LogTemp, Warning, TEXT("FGNetScenario: Could not load scenario %s"), *FilePath);
+			}
+		}
+	}
+
+	if (Scenario.IsRunning())
+	{
+		Scenario.Tick(DeltaTime, FFGNetStats::FindGameNetDriver());
+	}
+}
+
+bool FFGNetScenario::LoadFromFile(const FString& FilePath)
+{
+	FString Timeline;
+	return FFileHelper::LoadFileToString(Timeline, *FilePath) && LoadFromString(Timeline);
+}
+
+bool FFGNetScenario::LoadFromString(const FString& Timeline)
+{
+	TArray<FString> Lines;
+	Timeline.ParseIntoArrayLines(Lines);
+
+	TArray<FFGNetScenarioKeyframe> NewKeyframes;
+	FFGNetScenarioKeyframe State;
+
+	// Restore keyframes along with the time their burst starts
+	TArray<TPair<float, FFGNetScenarioKeyframe>> BurstRestores;
+
+	for (const FString& Line : Lines)
+	{
+		const FString TrimmedLine = Line.TrimStartAndEnd();
+		if (TrimmedLine.IsEmpty() || TrimmedLine.StartsWith(TEXT("#")))
+		{
+			continue;
+		}
+
+		TArray<FString> Tokens;
+		TrimmedLine.ParseIntoArrayWS(Tokens);
+
+		const FFGNetScenarioKeyframe PreviousState = State;
+		State.Time = FMath::Max(FCString::Atof(*Tokens[0]), 0.0f);
+
+		int32 BurstMs = 0;
+		for (int32 Index = 1; Index < Tokens.Num(); ++Index)
+		{
+			const FString& Token = Tokens[Index];
+			FString Key, Value;
+
+			if (Token.Split(TEXT("="), &Key, &Value) && Key == TEXT("Burst"))
+			{
+				BurstMs = FMath::Max(FMath::RoundToInt(FCString::Atof(*Value) * 1000.0f), 0);
+				continue;
+			}
+
+			const bool bParsed = FGNetScenario::ParseKey(Token, TEXT("Lag"), State.Lag)
+				|| FGNetScenario::ParseKey(Token, TEXT("Jitter"), State.Jitter)
+				|| FGNetScenario::ParseKey(Token, TEXT("Loss"), State.Loss)
+				|| FGNetScenario::ParseKey(Token, TEXT("InLag"), State.IncomingLag)
+				|| FGNetScenario::ParseKey(Token, TEXT("InJitter"), State.IncomingJitter)
+				|| FGNetScenario::ParseKey(Token, TEXT("InLoss"), State.IncomingLoss)
+				|| FGNetScenario::ParseKey(Token, TEXT("Order"), State.Order)
+				|| FGNetScenario::ParseKey(Token, TEXT("Dup"), State.Duplicate);
+
+			if (!bParsed)
+			{
+				UE_LOG(LogTemp, Warning, TEXT("FGNetScenario: Unknown key %s"), *Token);
+			}
+		}
+
+		State.Loss = FMath::Min(State.Loss, 100);
+		State.IncomingLoss = FMath::Min(State.IncomingLoss, 100);
+		State.Order = FMath::Min(State.Order, 1);
+		State.Duplicate = FMath::Min(State.Duplicate, 100);
+		NewKeyframes.Add(State);
+
+		if (BurstMs > 0)
+		{
+			// Bursts don't change the state later keyframes carry over from
+			FFGNetScenarioKeyframe Restore = PreviousState;
+			Restore.Time = State.Time + BurstMs / 1000.0f;
+			BurstRestores.Emplace(State.Time, Restore);
+			State = PreviousState;
+		}
+	}
+
+	if (NewKeyframes.Num() == 0)
+	{
+		return false;
+	}
+
+	const auto SortByTime = [](const FFGNetScenarioKeyframe& A, const FFGNetScenarioKeyframe& B) { return A.Time < B.Time; };
+	NewKeyframes.StableSort(SortByTime);
+
+	// A keyframe that starts during a burst already ends it, restoring afterwards would revert that keyframe
+	const int32 NumTimelineKeyframes = NewKeyframes.Num();
+	for (const TPair<float, FFGNetScenarioKeyframe>& BurstRestore : BurstRestores)
+	{
+		const int32 NextIndex = Algo::UpperBoundBy(MakeArrayView(NewKeyframes.GetData(), NumTimelineKeyframes), BurstRestore.Key, &FFGNetScenarioKeyframe::Time);
+		if (NextIndex == NumTimelineKeyframes || NewKeyframes[NextIndex].Time > BurstRestore.Value.Time)
+		{
+			NewKeyframes.Add(BurstRestore.Value);
+		}
+	}
+
+	NewKeyframes.StableSort(SortByTime);
+	Keyframes = MoveTemp(NewKeyframes);
+	return true;
+}
+
+void FFGNetScenario::Start(int32 InSeed)
+{
+	Seed = InSeed;
+	ElapsedTime = 0.0f;
+	CurrentKeyframe = INDEX_NONE;
+	AppliedNetDriver = nullptr;
+	bIsRunning = Keyframes.Num() > 0;
+
+	UE_LOG(LogTemp, Display, TEXT("FGNetScenario: Starting scenario with %d keyframes and seed %d"), Keyframes.Num(), Seed);
+}
+
+void FFGNetScenario::Stop()
+{
+	bIsRunning = false;
+
+	if (UNetDriver* NetDriver = AppliedNetDriver.Get())
+	{
+		// Packets still delayed go out right away
+		TArray<UNetConnection*> Connections;
+		FGNetScenario::GetConnections(*NetDriver, Connections);
+
+		for (UNetConnection* Connection : Connections)
+		{
+			if (UFGSimulatedIpConnection* SimulatedConnection = Cast<UFGSimulatedIpConnection>(Connection))
+			{
+				SimulatedConnection->ClearSimulation();
+			}
+		}
+
+#if DO_ENABLE_NET_TEST
+		NetDriver->SetPacketSimulationSettings(FPacketSimulationSettings());
+#endif // DO_ENABLE_NET_TEST
+	}
+
+	AppliedNetDriver = nullptr;
+}
+
+void FFGNetScenario::Tick(float DeltaTime, UNetDriver* NetDriver)
+{
+	// The timeline starts when there is something to simulate on, so loading time doesn't eat into it
+	if (!bIsRunning || NetDriver == nullptr)
+	{
+		return;
+	}
+
+	int32 TargetKeyframe = FMath::Max(CurrentKeyframe, 0);
+	while (TargetKeyframe + 1 < Keyframes.Num() && Keyframes[TargetKeyframe + 1].Time <= ElapsedTime)
+	{
+		TargetKeyframe++;
+	}
+
+	const bool bKeyframeChanged = TargetKeyframe != CurrentKeyframe || AppliedNetDriver.Get() != NetDriver;
+	if (bKeyframeChanged)
+	{
+		ApplyKeyframe(TargetKeyframe, *NetDriver);
+	}
+
+	UpdateConnections(*NetDriver, bKeyframeChanged);
+
+	ElapsedTime += DeltaTime;
+}
+
+void FFGNetScenario::ApplyKeyframe(int32 KeyframeIndex, UNetDriver& NetDriver)
+{
+	CurrentKeyframe = KeyframeIndex;
+	AppliedNetDriver = &NetDriver;
+
+#if DO_ENABLE_NET_TEST
+	const FFGNetScenarioKeyframe& Keyframe = Keyframes[KeyframeIndex];
+
+	UE_LOG(LogTemp, Display, TEXT("FGNetScenario: %.2fs Lag=%d+%d Loss=%d InLag=%d+%d InLoss=%d Order=%d Dup=%d"),
+		Keyframe.Time, Keyframe.Lag, Keyframe.Jitter, Keyframe.Loss, Keyframe.IncomingLag, Keyframe.IncomingJitter, Keyframe.IncomingLoss, Keyframe.Order, Keyframe.Duplicate);
+
+	// Simulated connections do it all themselves, the engine's simulation would come on top
+	FPacketSimulationSettings PacketSimulation;
+
+	if (NetDriver.NetConnectionClass == nullptr || !NetDriver.NetConnectionClass->IsChildOf(UFGSimulatedIpConnection::StaticClass()))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("FGNetScenario: %s doesn't use FGSimulatedIpConnection, loss, order and duplication follow the global random stream"), *NetDriver.GetName());
+
+		// Same seed and keyframe starts the same sequence of rolls, as long as nothing else draws from the stream in between
+		FMath::RandInit(Seed + KeyframeIndex);
+
+		PacketSimulation.PktLagMin = Keyframe.Lag;
+		PacketSimulation.PktLagMax = Keyframe.Lag + Keyframe.Jitter;
+		PacketSimulation.PktLoss = Keyframe.Loss;
+		PacketSimulation.PktIncomingLagMin = Keyframe.IncomingLag;
+		PacketSimulation.PktIncomingLagMax = Keyframe.IncomingLag + Keyframe.IncomingJitter;
+		PacketSimulation.PktIncomingLoss = Keyframe.IncomingLoss;
+		PacketSimulation.PktOrder = Keyframe.Order;
+		PacketSimulation.PktDup = Keyframe.Duplicate;
+	}
+
+	NetDriver.SetPacketSimulationSettings(PacketSimulation);
+#endif // DO_ENABLE_NET_TEST
+}
+
+void FFGNetScenario::UpdateConnections(UNetDriver& NetDriver, bool bKeyframeChanged)
+{
+	const FFGNetScenarioKeyframe& Keyframe = Keyframes[CurrentKeyframe];
+	const double Now = FPlatformTime::Seconds();
+
+	TArray<UNetConnection*> Connections;
+	FGNetScenario::GetConnections(NetDriver, Connections);
+
+	for (int32 Index = 0; Index < Connections.Num(); ++Index)
+	{
+		UFGSimulatedIpConnection* Connection = Cast<UFGSimulatedIpConnection>(Connections[Index]);
+		if (Connection == nullptr)
+		{
+			continue;
+		}
+
+		// Connections that join during a keyframe start its streams from the beginning
+		if (bKeyframeChanged || !Connection->IsSimulating())
+		{
+			const uint32 KeyframeSeed = HashCombine(static_cast<uint32>(Seed), static_cast<uint32>(CurrentKeyframe));
+			Connection->SetSimulation(Keyframe, static_cast<int32>(HashCombine(KeyframeSeed, static_cast<uint32>(Index))));
+		}
+
+		Connection->ReleaseDelayedPackets(Now);
+	}
+}
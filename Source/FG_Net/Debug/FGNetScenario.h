@@ -0,0 +1,65 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtr.h"
+
+class UNetDriver;
+
+// Packet simulation state from a given time in a scenario. Values carry over from the previous keyframe unless set.
+struct FFGNetScenarioKeyframe
+{
+	float Time = 0.0f;
+
+	// Outgoing packets
+	int32 Lag = 0;
+	int32 Jitter = 0;
+	int32 Loss = 0;
+
+	// Incoming packets
+	int32 IncomingLag = 0;
+	int32 IncomingJitter = 0;
+	int32 IncomingLoss = 0;
+
+	// Non-zero lets packets overtake each other, jitter keeps them in order otherwise
+	int32 Order = 0;
+
+	// Percentage of packets sent twice
+	int32 Duplicate = 0;
+};
+
+// Plays back a timeline of packet simulation settings on the game net driver.
+// Timeline files have one keyframe per line: "<Time> Key=Value ...", keys being Lag, Jitter, Loss, InLag, InJitter, InLoss, Order and Dup.
+// "Burst=<Seconds>" on a line makes its settings revert to the previous keyframe after that many seconds, unless the next keyframe comes first.
+// With UFGSimulatedIpConnection as the driver's connection class, each connection rolls loss, duplication and lag per packet from streams seeded
+// by the seed, keyframe and its place in the driver's connection list, so a scenario and seed treat the same packets the same way every run.
+// Other connection classes fall back to the engine's packet simulation, with the global FMath::Rand stream reseeded per keyframe.
+// That stream is shared with every other FMath::Rand, FRand, RandRange and VRand caller in the engine and game, so the fallback only repeats as far as they do.
+class FG_NET_API FFGNetScenario
+{
+public:
+	// Scenario started from the commandline with -FGNetScenario=<File> [-FGNetScenarioSeed=<Seed>] or from the debug widget
+	static FFGNetScenario& Get();
+	static void TickGlobal(float DeltaTime);
+
+	bool LoadFromFile(const FString& FilePath);
+	bool LoadFromString(const FString& Timeline);
+
+	void Start(int32 InSeed);
+	void Stop();
+	void Tick(float DeltaTime, UNetDriver* NetDriver);
+
+	bool IsRunning() const { return bIsRunning; }
+	float GetElapsedTime() const { return ElapsedTime; }
+	int32 GetSeed() const { return Seed; }
+
+private:
+	void ApplyKeyframe(int32 KeyframeIndex, UNetDriver& NetDriver);
+	void UpdateConnections(UNetDriver& NetDriver, bool bKeyframeChanged);
+
+	TArray<FFGNetScenarioKeyframe> Keyframes;
+	TWeakObjectPtr<UNetDriver> AppliedNetDriver;
+	int32 Seed = 0;
+	int32 CurrentKeyframe = INDEX_NONE;
+	float ElapsedTime = 0.0f;
+	bool bIsRunning = false;
+};
@@ -0,0 +1,175 @@
+#include "FGNetStats.h"
+#include "Engine/Engine.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+
+DEFINE_STAT(STAT_FGPlayerTick);
+DEFINE_STAT(STAT_FGRocketTick);
+DEFINE_STAT(STAT_FGPickupTick);
+DEFINE_STAT(STAT_FGValueReplicatorTick);
+DEFINE_STAT(STAT_FGServerSendMovement);
+DEFINE_STAT(STAT_FGApplyRemoteMovement);
+DEFINE_STAT(STAT_FGNetDebugWidget);
+DEFINE_STAT(STAT_FGMovementComponentMove);
+DEFINE_STAT(STAT_FGProxyMovement);
+DEFINE_STAT(STAT_FGSnapshots);
+DEFINE_STAT(STAT_FGTickRateGovernor);
+DEFINE_STAT(STAT_FGMovementSweeps);
+DEFINE_STAT(STAT_FGSleepingMoves);
+DEFINE_STAT(STAT_FGBatchedProxies);
+DEFINE_STAT(STAT_FGFullSnapshots);
+
+DEFINE_STAT(STAT_FGMovementRPCsPerSecond);
+DEFINE_STAT(STAT_FGMovementBytesPerSecond);
+DEFINE_STAT(STAT_FGFireRPCsPerSecond);
+DEFINE_STAT(STAT_FGFireBytesPerSecond);
+DEFINE_STAT(STAT_FGPickupRPCsPerSecond);
+DEFINE_STAT(STAT_FGPickupBytesPerSecond);
+DEFINE_STAT(STAT_FGReplicatorRPCsPerSecond);
+DEFINE_STAT(STAT_FGReplicatorBytesPerSecond);
+DEFINE_STAT(STAT_FGMovementUpdates);
+DEFINE_STAT(STAT_FGMovementSnaps);
+DEFINE_STAT(STAT_FGLastPredictionError);
+DEFINE_STAT(STAT_FGCrumbTrailDepth);
+DEFINE_STAT(STAT_FGServerTickRate);
+DEFINE_STAT(STAT_FGServerFrameLoad);
+DEFINE_STAT(STAT_FGNetUpdateFrequencyScale);
+
+CSV_DEFINE_CATEGORY_MODULE(FG_NET_API, FGNet, true);
+
+namespace FGNetStats
+{
+	static const int32 NumRPCTypes = static_cast<int32>(EFGNetRPCType::Num);
+
+	// Counted during the current second
+	static int32 RPCCount[NumRPCTypes] = {};
+	static int32 RPCBytes[NumRPCTypes] = {};
+
+	// Published for the previous second
+	static int32 RPCsPerSecond[NumRPCTypes] = {};
+	static int32 BytesPerSecond[NumRPCTypes] = {};
+
+	static float WindowElapsed = 0.0f;
+}
+
+void FFGNetStats::RecordRPC(EFGNetRPCType Type, int32 NumBytes)
+{
+	check(IsInGameThread());
+
+	const int32 Index = static_cast<int32>(Type);
+	FGNetStats::RPCCount[Index]++;
+	FGNetStats::RPCBytes[Index] += NumBytes;
+}
+
+int32 FFGNetStats::GetRPCsPerSecond(EFGNetRPCType Type)
+{
+	return FGNetStats::RPCsPerSecond[static_cast<int32>(Type)];
+}
+
+int32 FFGNetStats::GetBytesPerSecond(EFGNetRPCType Type)
+{
+	return FGNetStats::BytesPerSecond[static_cast<int32>(Type)];
+}
+
+FFGScopedRPCStat::FFGScopedRPCStat(EFGNetRPCType InType, const AActor& Actor)
+	: Type(InType)
+{
+	if (UNetConnection* Connection = Actor.GetNetConnection())
+	{
+		Connections.Add(Connection);
+	}
+
+	StartBits = GetSentBits();
+}
+
+FFGScopedRPCStat::FFGScopedRPCStat(EFGNetRPCType InType, UNetDriver* NetDriver)
+	: Type(InType)
+{
+	if (NetDriver != nullptr)
+	{
+		Connections.Append(NetDriver->ClientConnections);
+	}
+
+	StartBits = GetSentBits();
+}
+
+FFGScopedRPCStat::~FFGScopedRPCStat()
+{
+	const int64 SentBits = GetSentBits() - StartBits;
+
+	if (SentBits > 0)
+	{
+		FFGNetStats::RecordRPC(Type, static_cast<int32>((SentBits + 7) / 8));
+	}
+}
+
+int64 FFGScopedRPCStat::GetSentBits() const
+{
+	// Bits still in the send buffer plus everything flushed so far, so a flush caused by the RPC is counted too, packet overhead included
+	int64 SentBits = 0;
+	for (const UNetConnection* Connection : Connections)
+	{
+		SentBits += static_cast<int64>(Connection->OutBytes) * 8 + Connection->SendBuffer.GetNumBits();
+	}
+
+	return SentBits;
+}
+
+UNetDriver* FFGNetStats::FindGameNetDriver()
+{
+	if (GEngine == nullptr)
+	{
+		return nullptr;
+	}
+
+	for (const FWorldContext& Context : GEngine->GetWorldContexts())
+	{
+		UWorld* World = Context.World();
+		if (World != nullptr && World->IsGameWorld() && World->GetNetDriver() != nullptr)
+		{
+			return World->GetNetDriver();
+		}
+	}
+
+	return nullptr;
+}
+
+void FFGNetStats::Tick(float DeltaTime)
+{
+	using namespace FGNetStats;
+
+	WindowElapsed += DeltaTime;
+
+	if (WindowElapsed >= 1.0f)
+	{
+		for (int32 Index = 0; Index < NumRPCTypes; ++Index)
+		{
+			RPCsPerSecond[Index] = FMath::RoundToInt(RPCCount[Index] / WindowElapsed);
+			BytesPerSecond[Index] = FMath::RoundToInt(RPCBytes[Index] / WindowElapsed);
+			RPCCount[Index] = 0;
+			RPCBytes[Index] = 0;
+		}
+
+		WindowElapsed = 0.0f;
+
+		SET_DWORD_STAT(STAT_FGMovementRPCsPerSecond, GetRPCsPerSecond(EFGNetRPCType::Movement));
+		SET_DWORD_STAT(STAT_FGMovementBytesPerSecond, GetBytesPerSecond(EFGNetRPCType::Movement));
+		SET_DWORD_STAT(STAT_FGFireRPCsPerSecond, GetRPCsPerSecond(EFGNetRPCType::Fire));
+		SET_DWORD_STAT(STAT_FGFireBytesPerSecond, GetBytesPerSecond(EFGNetRPCType::Fire));
+		SET_DWORD_STAT(STAT_FGPickupRPCsPerSecond, GetRPCsPerSecond(EFGNetRPCType::Pickup));
+		SET_DWORD_STAT(STAT_FGPickupBytesPerSecond, GetBytesPerSecond(EFGNetRPCType::Pickup));
+		SET_DWORD_STAT(STAT_FGReplicatorRPCsPerSecond, GetRPCsPerSecond(EFGNetRPCType::Replicator));
+		SET_DWORD_STAT(STAT_FGReplicatorBytesPerSecond, GetBytesPerSecond(EFGNetRPCType::Replicator));
+	}
+
+	CSV_CUSTOM_STAT(FGNet, MovementRPCsPerSecond, GetRPCsPerSecond(EFGNetRPCType::Movement), ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(FGNet, MovementBytesPerSecond, GetBytesPerSecond(EFGNetRPCType::Movement), ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(FGNet, FireRPCsPerSecond, GetRPCsPerSecond(EFGNetRPCType::Fire), ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(FGNet, FireBytesPerSecond, GetBytesPerSecond(EFGNetRPCType::Fire), ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(FGNet, PickupRPCsPerSecond, GetRPCsPerSecond(EFGNetRPCType::Pickup), ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(FGNet, PickupBytesPerSecond, GetBytesPerSecond(EFGNetRPCType::Pickup), ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(FGNet, ReplicatorRPCsPerSecond, GetRPCsPerSecond(EFGNetRPCType::Replicator), ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(FGNet, ReplicatorBytesPerSecond, GetBytesPerSecond(EFGNetRPCType::Replicator), ECsvCustomStatOp::Set);
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+
+DECLARE_STATS_GROUP(TEXT("FGNet"), STATGROUP_FGNet, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Player Tick"), STAT_FGPlayerTick, STATGROUP_FGNet, FG_NET_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Rocket Tick"), STAT_FGRocketTick, STATGROUP_FGNet, FG_NET_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Pickup Tick"), STAT_FGPickupTick, STATGROUP_FGNet, FG_NET_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Value Replicator Tick"), STAT_FGValueReplicatorTick, STATGROUP_FGNet, FG_NET_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Server Send Movement"), STAT_FGServerSendMovement, STATGROUP_FGNet, FG_NET_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Apply Remote Movement"), STAT_FGApplyRemoteMovement, STATGROUP_FGNet, FG_NET_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Net Debug Widget"), STAT_FGNetDebugWidget, STATGROUP_FGNet, FG_NET_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Movement Component Move"), STAT_FGMovementComponentMove, STATGROUP_FGNet, FG_NET_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Proxy Movement"), STAT_FGProxyMovement, STATGROUP_FGNet, FG_NET_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Snapshots"), STAT_FGSnapshots, STATGROUP_FGNet, FG_NET_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Tick Rate Governor"), STAT_FGTickRateGovernor, STATGROUP_FGNet, FG_NET_API);
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Movement Sweeps"), STAT_FGMovementSweeps, STATGROUP_FGNet, FG_NET_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Sleeping Moves"), STAT_FGSleepingMoves, STATGROUP_FGNet, FG_NET_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Batched Proxies"), STAT_FGBatchedProxies, STATGROUP_FGNet, FG_NET_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Full Snapshots"), STAT_FGFullSnapshots, STATGROUP_FGNet, FG_NET_API);
+
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Movement RPCs/s"), STAT_FGMovementRPCsPerSecond, STATGROUP_FGNet, FG_NET_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Movement Bytes/s"), STAT_FGMovementBytesPerSecond, STATGROUP_FGNet, FG_NET_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Fire RPCs/s"), STAT_FGFireRPCsPerSecond, STATGROUP_FGNet, FG_NET_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Fire Bytes/s"), STAT_FGFireBytesPerSecond, STATGROUP_FGNet, FG_NET_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Pickup RPCs/s"), STAT_FGPickupRPCsPerSecond, STATGROUP_FGNet, FG_NET_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Pickup Bytes/s"), STAT_FGPickupBytesPerSecond, STATGROUP_FGNet, FG_NET_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Replicator RPCs/s"), STAT_FGReplicatorRPCsPerSecond, STATGROUP_FGNet, FG_NET_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Replicator Bytes/s"), STAT_FGReplicatorBytesPerSecond, STATGROUP_FGNet, FG_NET_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Movement Updates"), STAT_FGMovementUpdates, STATGROUP_FGNet, FG_NET_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Movement Snaps"), STAT_FGMovementSnaps, STATGROUP_FGNet, FG_NET_API);
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Last Prediction Error"), STAT_FGLastPredictionError, STATGROUP_FGNet, FG_NET_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Crumb Trail Depth"), STAT_FGCrumbTrailDepth, STATGROUP_FGNet, FG_NET_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Server Tick Rate"), STAT_FGServerTickRate, STATGROUP_FGNet, FG_NET_API);
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Server Frame Load"), STAT_FGServerFrameLoad, STATGROUP_FGNet, FG_NET_API);
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Net Update Frequency Scale"), STAT_FGNetUpdateFrequencyScale, STATGROUP_FGNet, FG_NET_API);
+
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(FG_NET_API, FGNet);
+
+enum class EFGNetRPCType : uint8
+{
+	Movement,
+	Fire,
+	Pickup,
+	Replicator,
+	Num
+};
+
+struct FG_NET_API FFGNetStats
+{
+	// Counts an outgoing RPC and the bytes it took on the wire, usually through FFGScopedRPCStat
+	static void RecordRPC(EFGNetRPCType Type, int32 NumBytes);
+
+	static int32 GetRPCsPerSecond(EFGNetRPCType Type);
+	static int32 GetBytesPerSecond(EFGNetRPCType Type);
+
+	// Net driver of the first game world that has one, used by debug tooling that runs outside of a world
+	static class UNetDriver* FindGameNetDriver();
+
+	// Publishes the per second counters to the stats system and the CSV profiler
+	static void Tick(float DeltaTime);
+};
+
+// Records the RPC called in its scope with the bits it added to the connection it went out on.
+// RPCs that don't leave this machine, such as server RPCs called on a listen server, add none and aren't counted.
+class FG_NET_API FFGScopedRPCStat
+{
+public:
+	// Client and server RPCs, sent through the actor's owning connection
+	FFGScopedRPCStat(EFGNetRPCType InType, const class AActor& Actor);
+	// Multicast RPCs, measured across every client connection
+	FFGScopedRPCStat(EFGNetRPCType InType, class UNetDriver* NetDriver);
+	~FFGScopedRPCStat();
+
+	UE_NONCOPYABLE(FFGScopedRPCStat);
+
+private:
+	int64 GetSentBits() const;
+
+	EFGNetRPCType Type;
+	TArray<class UNetConnection*, TInlineAllocator<1>> Connections;
+	int64 StartBits = 0;
+};
@@ -0,0 +1,148 @@
+#include "FGSimulatedIpConnection.h"
+#include "Algo/BinarySearch.h"
+#include "HAL/PlatformTime.h"
+
+void UFGSimulatedIpConnection::LowLevelSend(void* Data, int32 CountBits, FOutPacketTraits& Traits)
+{
+	if (!bSimulating)
+	{
+		Super::LowLevelSend(Data, CountBits, Traits);
+		return;
+	}
+
+	// Every roll is made for every packet, so the stream stays in step whatever the settings are
+	double ReleaseTime = 0.0;
+	const bool bDelivered = RollPacket(OutgoingRandomStream, Simulation.Lag, Simulation.Jitter, Simulation.Loss, LastOutgoingReleaseTime, ReleaseTime);
+	const bool bDuplicate = OutgoingRandomStream.RandRange(0, 99) < Simulation.Duplicate;
+
+	if (!bDelivered)
+	{
+		return;
+	}
+
+	const int32 NumBytes = FMath::DivideAndRoundUp(CountBits, 8);
+	for (int32 Copy = 0; Copy < (bDuplicate ? 2 : 1); ++Copy)
+	{
+		FDelayedPacket Packet;
+		Packet.Data.Append(static_cast<const uint8*>(Data), NumBytes);
+		Packet.CountBits = CountBits;
+		Packet.Traits = Traits;
+		Packet.ReleaseTime = ReleaseTime;
+		AddDelayedPacket(DelayedOutgoing, MoveTemp(Packet));
+	}
+
+	ReleaseOutgoing(FPlatformTime::Seconds());
+}
+
+void UFGSimulatedIpConnection::ReceivedRawPacket(void* Data, int32 Count)
+{
+	if (!bSimulating)
+	{
+		Super::ReceivedRawPacket(Data, Count);
+		return;
+	}
+
+	double ReleaseTime = 0.0;
+	if (!RollPacket(IncomingRandomStream, Simulation.IncomingLag, Simulation.IncomingJitter, Simulation.IncomingLoss, LastIncomingReleaseTime, ReleaseTime))
+	{
+		return;
+	}
+
+	FDelayedPacket Packet;
+	Packet.Data.Append(static_cast<const uint8*>(Data), Count);
+	Packet.ReleaseTime = ReleaseTime;
+	AddDelayedPacket(DelayedIncoming, MoveTemp(Packet));
+
+	ReleaseIncoming(FPlatformTime::Seconds());
+}
+
+void UFGSimulatedIpConnection::SetSimulation(const FFGNetScenarioKeyframe& Keyframe, int32 Seed)
+{
+#if DO_ENABLE_NET_TEST
+	Simulation = Keyframe;
+	OutgoingRandomStream.Initialize(Seed);
+	IncomingRandomStream.Initialize(static_cast<int32>(HashCombine(static_cast<uint32>(Seed), 1)));
+	bSimulating = true;
+#endif // DO_ENABLE_NET_TEST
+}
+
+void UFGSimulatedIpConnection::ClearSimulation()
+{
+	bSimulating = false;
+	LastOutgoingReleaseTime = 0.0;
+	LastIncomingReleaseTime = 0.0;
+	ReleaseDelayedPackets(TNumericLimits<double>::Max());
+}
+
+void UFGSimulatedIpConnection::ReleaseDelayedPackets(double Now)
+{
+	ReleaseOutgoing(Now);
+	ReleaseIncoming(Now);
+}
+
+void UFGSimulatedIpConnection::ReleaseOutgoing(double Now)
+{
+	for (FDelayedPacket& Packet : TakeDuePackets(DelayedOutgoing, Now))
+	{
+		Super::LowLevelSend(Packet.Data.GetData(), Packet.CountBits, Packet.Traits);
+	}
+}
+
+void UFGSimulatedIpConnection::ReleaseIncoming(double Now)
+{
+	// Receiving a packet sends acks, which go through LowLevelSend and only release outgoing packets, so this doesn't nest
+	for (FDelayedPacket& Packet : TakeDuePackets(DelayedIncoming, Now))
+	{
+		if (State == USOCK_Closed)
+		{
+			break;
+		}
+
+		Super::ReceivedRawPacket(Packet.Data.GetData(), Packet.Data.Num());
+	}
+}
+
+bool UFGSimulatedIpConnection::RollPacket(FRandomStream& RandomStream, int32 Lag, int32 Jitter, int32 Loss, double& LastReleaseTime, double& OutReleaseTime) const
+{
+	const bool bLost = RandomStream.RandRange(0, 99) < Loss;
+	const int32 LagMs = Lag + RandomStream.RandRange(0, Jitter);
+
+	if (bLost)
+	{
+		return false;
+	}
+
+	OutReleaseTime = FPlatformTime::Seconds() + LagMs / 1000.0;
+
+	// Without Order a packet can't overtake the one before it, jitter only bunches them up
+	if (Simulation.Order == 0)
+	{
+		OutReleaseTime = FMath::Max(OutReleaseTime, LastReleaseTime);
+	}
+
+	LastReleaseTime = FMath::Max(OutReleaseTime, LastReleaseTime);
+	return true;
+}
+
+TArray<UFGSimulatedIpConnection::FDelayedPacket> UFGSimulatedIpConnection::TakeDuePackets(TArray<FDelayedPacket>& Packets, double Now)
+{
+	// Due packets are taken out before any is processed, as processing one can queue more
+	const int32 NumDue = Algo::UpperBoundBy(Packets, Now, &FDelayedPacket::ReleaseTime);
+	TArray<FDelayedPacket> DuePackets;
+	DuePackets.Reserve(NumDue);
+
+	for (int32 Index = 0; Index < NumDue; ++Index)
+	{
+		DuePackets.Add(MoveTemp(Packets[Index]));
+	}
+
+	Packets.RemoveAt(0, NumDue, false);
+	return DuePackets;
+}
+
+void UFGSimulatedIpConnection::AddDelayedPacket(TArray<FDelayedPacket>& Packets, FDelayedPacket&& Packet)
+{
+	// Sorted by release time, packets released at the same time keep the order they came in
+	const int32 Index = Algo::UpperBoundBy(Packets, Packet.ReleaseTime, &FDelayedPacket::ReleaseTime);
+	Packets.Insert(MoveTemp(Packet), Index);
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "IpConnection.h"
+#include "Math/RandomStream.h"
+#include "FGNetScenario.h"
+#include "FGSimulatedIpConnection.generated.h"
+
+// IP connection that applies the packet simulation of a running FFGNetScenario itself.
+// Loss, duplication, lag, jitter and reordering are rolled per packet from streams seeded by the scenario, so a scenario and seed drop and delay the same packets every run.
+// Passes packets straight through when no scenario is running, and always in builds without DO_ENABLE_NET_TEST.
+UCLASS(Transient, Config = Engine)
+class FG_NET_API UFGSimulatedIpConnection : public UIpConnection
+{
+	GENERATED_BODY()
+public:
+	virtual void LowLevelSend(void* Data, int32 CountBits, FOutPacketTraits& Traits) override;
+	virtual void ReceivedRawPacket(void* Data, int32 Count) override;
+
+	// Settings and seed for packets from now on. Packets already delayed keep their release time.
+	void SetSimulation(const FFGNetScenarioKeyframe& Keyframe, int32 Seed);
+
+	// Sends and receives everything still delayed and passes packets through again
+	void ClearSimulation();
+
+	// Sends and receives the delayed packets that are due at Now, in FPlatformTime::Seconds
+	void ReleaseDelayedPackets(double Now);
+
+	bool IsSimulating() const { return bSimulating; }
+
+private:
+	struct FDelayedPacket
+	{
+		TArray<uint8> Data;
+		int32 CountBits = 0;
+		FOutPacketTraits Traits;
+		double ReleaseTime = 0.0;
+	};
+
+	// Rolls loss and lag for one packet, returns false if it's dropped
+	bool RollPacket(FRandomStream& RandomStream, int32 Lag, int32 Jitter, int32 Loss, double& LastReleaseTime, double& OutReleaseTime) const;
+
+	void ReleaseOutgoing(double Now);
+	void ReleaseIncoming(double Now);
+
+	static TArray<FDelayedPacket> TakeDuePackets(TArray<FDelayedPacket>& Packets, double Now);
+	static void AddDelayedPacket(TArray<FDelayedPacket>& Packets, FDelayedPacket&& Packet);
+
+	TArray<FDelayedPacket> DelayedOutgoing;
+	TArray<FDelayedPacket> DelayedIncoming;
+	FFGNetScenarioKeyframe Simulation;
+	FRandomStream OutgoingRandomStream;
+	FRandomStream IncomingRandomStream;
+	double LastOutgoingReleaseTime = 0.0;
+	double LastIncomingReleaseTime = 0.0;
+	bool bSimulating = false;
+};
@@ -1,9 +1,31 @@
 #include "FGNetDebugWidget.h"
 #include "Engine/World.h"
 #include "Engine/NetDriver.h"
+#include "Engine/NetConnection.h"
 #include "GameFramework/PlayerController.h"
 #include "GameFramework/PlayerState.h"
 #include "Misc/DefaultValueHelper.h"
+#include "Rendering/DrawElements.h"
+#include "Styling/CoreStyle.h"
+#include "../FGNetScenario.h"
+#include "../FGNetStats.h"
+#include "../FGCorrectionTelemetry.h"
+#include "../../Player/FGPlayer.h"
+
+void FFGNetGraphSeries::AddSample(float Value)
+{
+	Samples[Head] = Value;
+	Head = (Head + 1) % NumSamples;
+	Num = FMath::Min(Num + 1, NumSamples);
+
+	MaxValue = 0.0f;
+	for (int32 Index = 0; Index < Num; ++Index)
+	{
+		MaxValue = FMath::Max(MaxValue, GetSample(Index));
+	}
+
+	Label = FString::Printf(TEXT("%s %.1f %s (max %.1f)"), *Name, Value, *Unit, MaxValue);
+}
 
 void UFGNetDebugWidget::UpdateNetworkSimualtionSettings(const FFGBlueprintNetworkSimulationSettings& InPackets)
 {
@@ -11,6 +33,9 @@ void UFGNetDebugWidget::UpdateNetworkSimualtionSettings(const FFGBlueprintNetwor
 	{
 		if (World->GetNetDriver() != nullptr)
 		{
+			// Manual settings take over from a running scenario
+			FFGNetScenario::Get().Stop();
+
 			FPacketSimulationSettings PacketSimulation;
 			PacketSimulation.PktLagMin = InPackets.MinLatency;
 			PacketSimulation.PktLagMax = InPackets.MaxLatency;
@@ -24,19 +49,190 @@ void UFGNetDebugWidget::UpdateNetworkSimualtionSettings(const FFGBlueprintNetwor
 			SimulationSettingsText.MaxLatency = FText::FromString(FString::FromInt(InPackets.MaxLatency));
 			SimulationSettingsText.MinLatency = FText::FromString(FString::FromInt(InPackets.MinLatency));
 			SimulationSettingsText.PacketLossPercentage = FText::FromString(FString::FromInt(InPackets.PacketLossPercent));
+			BP_OnUpdateNetworkSimulationSettings(SimulationSettingsText);
 		}
 	}
 }
 
+bool UFGNetDebugWidget::StartNetworkScenario(const FString& FilePath, int32 Seed)
+{
+	FFGNetScenario& Scenario = FFGNetScenario::Get();
+	Scenario.Stop();
+
+	if (!Scenario.LoadFromFile(FilePath))
+	{
+		return false;
+	}
+
+	Scenario.Start(Seed);
+	return true;
+}
+
+void UFGNetDebugWidget::StopNetworkScenario()
+{
+	FFGNetScenario::Get().Stop();
+}
+
+void UFGNetDebugWidget::NativeConstruct()
+{
+	Super::NativeConstruct();
+
+	struct FGraphDesc
+	{
+		const TCHAR* Name;
+		const TCHAR* Unit;
+		FLinearColor Color;
+	};
+
+	static const FGraphDesc GraphDescs[] =
+	{
+		{ TEXT("Ping"), TEXT("ms"), FLinearColor::Green },
+		{ TEXT("Jitter"), TEXT("ms"), FLinearColor::Yellow },
+		{ TEXT("Packet Loss"), TEXT("%"), FLinearColor::Red },
+		{ TEXT("In"), TEXT("B/s"), FLinearColor(0.2f, 0.6f, 1.0f) },
+		{ TEXT("Out"), TEXT("B/s"), FLinearColor(1.0f, 0.5f, 0.1f) },
+		{ TEXT("RPCs"), TEXT("/s"), FLinearColor(0.8f, 0.4f, 1.0f) },
+		{ TEXT("Server Frame"), TEXT("ms"), FLinearColor::White },
+		{ TEXT("Corrections"), TEXT("/s"), FLinearColor(1.0f, 0.3f, 0.6f) },
+	};
+	static_assert(UE_ARRAY_COUNT(GraphDescs) == static_cast<int32>(EFGNetGraph::Num), "Every graph needs a description");
+
+	Graphs.SetNum(static_cast<int32>(EFGNetGraph::Num));
+	for (int32 Index = 0; Index < Graphs.Num(); ++Index)
+	{
+		Graphs[Index].Name = GraphDescs[Index].Name;
+		Graphs[Index].Unit = GraphDescs[Index].Unit;
+		Graphs[Index].Color = GraphDescs[Index].Color;
+	}
+
+	GraphPoints.Reserve(FFGNetGraphSeries::NumSamples);
+	PreviousSnaps = FFGCorrectionTelemetry::GetTotalSnaps();
+}
+
 void UFGNetDebugWidget::NativeTick(const FGeometry& MyGeometry, float InDeltaTime)
 {
+	SCOPE_CYCLE_COUNTER(STAT_FGNetDebugWidget);
+
 	Super::NativeTick(MyGeometry, InDeltaTime);
 
-	if (APlayerController* PC = GetOwningPlayer())
+	TimeUntilSample -= InDeltaTime;
+	if (TimeUntilSample <= 0.0f)
+	{
+		TimeUntilSample = FMath::Max(TimeUntilSample + SampleInterval, 0.0f);
+		SampleGraphs(SampleInterval);
+	}
+}
+
+void UFGNetDebugWidget::SampleGraphs(float SampleDeltaTime)
+{
+	APlayerController* PC = GetOwningPlayer();
+	if (PC == nullptr)
+	{
+		return;
+	}
+
+	const AFGPlayer* Player = PC->GetPawn<AFGPlayer>();
+	const FFGRttEstimator* Estimator = Player != nullptr ? &Player->GetRttEstimator() : nullptr;
+
+	float Ping = 0.0f;
+	float Jitter = 0.0f;
+	if (Estimator != nullptr && Estimator->HasSamples())
+	{
+		Ping = Estimator->GetSmoothedRtt() * 1000.0f;
+		Jitter = Estimator->GetJitter() * 1000.0f;
+	}
+	else if (APlayerState* PlayerState = PC->GetPlayerState<APlayerState>())
+	{
+		Ping = PlayerState->ExactPing;
+	}
+
+	BP_UpdatePing(FMath::RoundToInt(Ping));
+
+	GetGraph(EFGNetGraph::Ping).AddSample(Ping);
+	GetGraph(EFGNetGraph::Jitter).AddSample(Jitter);
+
+	float PacketLossPercent = 0.0f;
+	int32 InBytesPerSecond = 0;
+	int32 OutBytesPerSecond = 0;
+
+	if (UNetConnection* Connection = PC->GetNetConnection())
 	{
-		if (APlayerState* PlayerState = PC->GetPlayerState<APlayerState>())
+		const int32 PacketsLost = Connection->InTotalPacketsLost + Connection->OutTotalPacketsLost;
+		const int32 NewPackets = (Connection->InTotalPackets - PreviousInPackets) + (Connection->OutTotalPackets - PreviousOutPackets);
+		PacketLossPercent = NewPackets > 0 ? 100.0f * (PacketsLost - PreviousPacketsLost) / NewPackets : 0.0f;
+
+		PreviousPacketsLost = PacketsLost;
+		PreviousInPackets = Connection->InTotalPackets;
+		PreviousOutPackets = Connection->OutTotalPackets;
+		InBytesPerSecond = Connection->InBytesPerSecond;
+		OutBytesPerSecond = Connection->OutBytesPerSecond;
+	}
+
+	GetGraph(EFGNetGraph::PacketLoss).AddSample(PacketLossPercent);
+	GetGraph(EFGNetGraph::InBytes).AddSample(InBytesPerSecond);
+	GetGraph(EFGNetGraph::OutBytes).AddSample(OutBytesPerSecond);
+
+	int32 RPCsPerSecond = 0;
+	for (int32 Type = 0; Type < static_cast<int32>(EFGNetRPCType::Num); ++Type)
+	{
+		RPCsPerSecond += FFGNetStats::GetRPCsPerSecond(static_cast<EFGNetRPCType>(Type));
+	}
+	GetGraph(EFGNetGraph::RPCs).AddSample(RPCsPerSecond);
+
+	// Clients only know the server's frame time from what it sends them
+	float ServerFrameTime = FPlatformTime::ToMilliseconds(GGameThreadTime);
+	if (PC->GetNetMode() == NM_Client)
+	{
+		ServerFrameTime = Player != nullptr ? Player->GetServerFrameTime() : 0.0f;
+	}
+	GetGraph(EFGNetGraph::ServerFrameTime).AddSample(ServerFrameTime);
+
+	const int32 TotalSnaps = FFGCorrectionTelemetry::GetTotalSnaps();
+	GetGraph(EFGNetGraph::Corrections).AddSample(FMath::Max(TotalSnaps - PreviousSnaps, 0) / SampleDeltaTime);
+	PreviousSnaps = TotalSnaps;
+}
+
+int32 UFGNetDebugWidget::NativePaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const
+{
+	int32 MaxLayerId = Super::NativePaint(Args, AllottedGeometry, MyCullingRect, OutDrawElements, LayerId, InWidgetStyle, bParentEnabled);
+
+	if (!bDrawGraphs)
+	{
+		return MaxLayerId;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_FGNetDebugWidget);
+
+	const FSlateBrush* BackgroundBrush = FCoreStyle::Get().GetBrush(TEXT("WhiteBrush"));
+	const FSlateFontInfo LabelFont = FCoreStyle::GetDefaultFontStyle("Mono", 8);
+	const int32 BackgroundLayer = MaxLayerId + 1;
+	const int32 GraphLayer = MaxLayerId + 2;
+
+	for (int32 GraphIndex = 0; GraphIndex < Graphs.Num(); ++GraphIndex)
+	{
+		const FFGNetGraphSeries& Graph = Graphs[GraphIndex];
+		const FVector2D Offset = GraphOrigin + FVector2D(0.0f, GraphIndex * (GraphSize.Y + GraphSpacing));
+		const FPaintGeometry PaintGeometry = AllottedGeometry.ToPaintGeometry(Offset, GraphSize);
+
+		FSlateDrawElement::MakeBox(OutDrawElements, BackgroundLayer, PaintGeometry, BackgroundBrush, ESlateDrawEffect::None, FLinearColor(0.0f, 0.0f, 0.0f, 0.5f));
+
+		if (Graph.Num > 1)
 		{
-			BP_UpdatePing(static_cast<int32>(PlayerState->GetPing()));
+			const float StepX = GraphSize.X / (FFGNetGraphSeries::NumSamples - 1);
+			const float ScaleY = Graph.MaxValue > KINDA_SMALL_NUMBER ? GraphSize.Y / Graph.MaxValue : 0.0f;
+			const float StartX = GraphSize.X - StepX * (Graph.Num - 1);
+
+			GraphPoints.Reset();
+			for (int32 Index = 0; Index < Graph.Num; ++Index)
+			{
+				GraphPoints.Add(FVector2D(StartX + StepX * Index, GraphSize.Y - Graph.GetSample(Index) * ScaleY));
+			}
+
+			FSlateDrawElement::MakeLines(OutDrawElements, GraphLayer, PaintGeometry, GraphPoints, ESlateDrawEffect::None, Graph.Color, true, 1.0f);
 		}
+
+		FSlateDrawElement::MakeText(OutDrawElements, GraphLayer, AllottedGeometry.ToPaintGeometry(Offset + FVector2D(4.0f, 2.0f), GraphSize), Graph.Label, LabelFont, ESlateDrawEffect::None, Graph.Color);
 	}
-}
\ No newline at end of file
+
+	return GraphLayer;
+}
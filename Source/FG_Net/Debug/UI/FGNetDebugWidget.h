@@ -39,6 +39,38 @@ public:
 	FText PacketLossPercentage;
 };
 
+// Fixed-size ring buffer of samples for one of the debug widget's graphs
+struct FFGNetGraphSeries
+{
+	static constexpr int32 NumSamples = 120;
+
+	FString Name;
+	FString Unit;
+	FLinearColor Color = FLinearColor::White;
+	float Samples[NumSamples] = {};
+	int32 Head = 0;
+	int32 Num = 0;
+	float MaxValue = 0.0f;
+	// Rebuilt when sampled rather than when painted
+	FString Label;
+
+	void AddSample(float Value);
+	float GetSample(int32 Index) const { return Samples[(Head - Num + Index + NumSamples) % NumSamples]; }
+};
+
+enum class EFGNetGraph : uint8
+{
+	Ping,
+	Jitter,
+	PacketLoss,
+	InBytes,
+	OutBytes,
+	RPCs,
+	ServerFrameTime,
+	Corrections,
+	Num
+};
+
 UCLASS()
 class FG_NET_API UFGNetDebugWidget : public UUserWidget
 {
@@ -47,10 +79,19 @@ public:
 	UFUNCTION(BlueprintCallable, Category = Widget)
 	void UpdateNetworkSimualtionSettings(const FFGBlueprintNetworkSimulationSettings& InPackets);
 
+	// Plays back a timeline file of network conditions, see FFGNetScenario for the format
+	UFUNCTION(BlueprintCallable, Category = Widget)
+	bool StartNetworkScenario(const FString& FilePath, int32 Seed);
+
+	UFUNCTION(BlueprintCallable, Category = Widget)
+	void StopNetworkScenario();
+
 	UFUNCTION(BlueprintImplementableEvent, Category = Widget, meta = (DisplayName = "On Update Network Simulation Settings"))
 	void BP_OnUpdateNetworkSimulationSettings(const FFGBlueprintNetworkSimulationSettingsText& Packets);
 
+	virtual void NativeConstruct() override;
 	virtual void NativeTick(const FGeometry& MyGeometry, float InDeltaTime) override;
+	virtual int32 NativePaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const override;
 
 	UFUNCTION(BlueprintImplementableEvent, Category = Widget, meta = (DisplayName = "On Update Ping"))
 	void BP_UpdatePing(int32 Ping);
@@ -60,4 +101,35 @@ public:
 
 	UFUNCTION(BlueprintImplementableEvent, Category = Widget, meta = (DisplayName = "On Hide Widget"))
 	void BP_OnHideWidget();
+
+	UPROPERTY(EditAnywhere, Category = Graphs)
+	bool bDrawGraphs = true;
+
+	// Seconds between graph samples, the graphs cover NumSamples of these
+	UPROPERTY(EditAnywhere, Category = Graphs, meta = (ClampMin = 0.02))
+	float SampleInterval = 0.25f;
+
+	// Top left corner of the first graph, in widget space
+	UPROPERTY(EditAnywhere, Category = Graphs)
+	FVector2D GraphOrigin = FVector2D(16.0f, 16.0f);
+
+	UPROPERTY(EditAnywhere, Category = Graphs)
+	FVector2D GraphSize = FVector2D(240.0f, 40.0f);
+
+	UPROPERTY(EditAnywhere, Category = Graphs)
+	float GraphSpacing = 4.0f;
+
+private:
+	void SampleGraphs(float SampleDeltaTime);
+	FFGNetGraphSeries& GetGraph(EFGNetGraph Graph) { return Graphs[static_cast<int32>(Graph)]; }
+
+	TArray<FFGNetGraphSeries> Graphs;
+	// Reused between paints so drawing doesn't allocate
+	mutable TArray<FVector2D> GraphPoints;
+
+	float TimeUntilSample = 0.0f;
+	int32 PreviousInPackets = 0;
+	int32 PreviousOutPackets = 0;
+	int32 PreviousPacketsLost = 0;
+	int32 PreviousSnaps = 0;
 };
\ No newline at end of file
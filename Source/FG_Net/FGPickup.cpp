@@ -6,6 +6,8 @@
 #include "TimerManager.h"
 #include "Player/FGPlayer.h"
 #include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
+#include "Debug/FGNetStats.h"
 
 AFGPickup::AFGPickup()
 {
@@ -23,14 +25,54 @@ AFGPickup::AFGPickup()
 	MeshComponent->SetCollisionProfileName(TEXT("NoCollision"));
 
 	SetReplicates(true);
+	NetDormancy = DORM_Initial;
+}
+
+void AFGPickup::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+	DOREPLIFETIME_WITH_PARAMS_FAST(AFGPickup, bPickedUp, Params);
+}
+
+void AFGPickup::OnRep_PickedUp()
+{
+	ApplyPickedUpState();
+}
+
+void AFGPickup::SetPickedUp(bool bNewPickedUp)
+{
+	bPickedUp = bNewPickedUp;
+	ApplyPickedUpState();
+
+	if (HasAuthority())
+	{
+		MARK_PROPERTY_DIRTY_FROM_NAME(AFGPickup, bPickedUp, this);
+		FlushNetDormancy();
+	}
+}
+
+void AFGPickup::ApplyPickedUpState()
+{
+	if (bPickedUp)
+	{
+		SphereComponent->SetCollisionProfileName(TEXT("NoCollision"));
+		HidePickup();
+		SetActorTickEnabled(false);
+	}
+	else
+	{
+		ShowPickup();
+		SphereComponent->SetCollisionProfileName(TEXT("OverlapAllDynamic"));
+		SetActorTickEnabled(ShouldAnimateMesh());
+	}
 }
 
 void AFGPickup::ReActivatePickup()
 {
-	bPickedUp = false;
-	ShowPickup();
-	SphereComponent->SetCollisionProfileName(TEXT("OverlapAllDynamic"));
-	SetActorTickEnabled(true);
+	SetPickedUp(false);
 
 	if (const UWorld* World = GetWorld())
 	{
@@ -57,6 +99,11 @@ void AFGPickup::BeginPlay()
 
 	SphereComponent->OnComponentBeginOverlap.AddDynamic(this, &AFGPickup::OverlapBegin);
 	CachedMeshRelativeLocation = MeshComponent->GetRelativeLocation();
+
+	if (!ShouldAnimateMesh())
+	{
+		SetActorTickEnabled(false);
+	}
 }
 
 void AFGPickup::EndPlay(const EEndPlayReason::Type EndPlayReason)
@@ -71,6 +118,9 @@ void AFGPickup::EndPlay(const EEndPlayReason::Type EndPlayReason)
 
 void AFGPickup::Tick(float DeltaTime)
 {
+	SCOPE_CYCLE_COUNTER(STAT_FGPickupTick);
+	CSV_SCOPED_TIMING_STAT(FGNet, PickupTick);
+
 	Super::Tick(DeltaTime);
 
 	const float PulsatingValue = FMath::MakePulsatingValue(GetWorld()->GetTimeSeconds(), 0.65f) * 30.0f;
@@ -80,6 +130,11 @@ void AFGPickup::Tick(float DeltaTime)
 	MeshComponent->SetRelativeRotation(FRotator(0.0f, 20.0f * DeltaTime, 0.0f), false, &Hit, ETeleportType::TeleportPhysics);
 }
 
+bool AFGPickup::ShouldAnimateMesh() const
+{
+	return !IsNetMode(NM_DedicatedServer);
+}
+
 bool AFGPickup::IsPickedUp()
 {
 	return bPickedUp;
@@ -87,11 +142,13 @@ bool AFGPickup::IsPickedUp()
 
 void AFGPickup::HandlePickup()
 {
-	bPickedUp = true;
-	SphereComponent->SetCollisionProfileName(TEXT("NoCollision"));
-	HidePickup();
-	GetWorldTimerManager().SetTimer(ReActivateHandle, this, &AFGPickup::ReActivatePickup, ReActivateTime, false);
-	SetActorTickEnabled(false);
+	SetPickedUp(true);
+
+	// Clients follow bPickedUp, so only the server times the respawn
+	if (HasAuthority())
+	{
+		GetWorldTimerManager().SetTimer(ReActivateHandle, this, &AFGPickup::ReActivatePickup, ReActivateTime, false);
+	}
 }
 
 void AFGPickup::HidePickup()
@@ -21,9 +21,20 @@ class FG_NET_API AFGPickup : public AActor
 private:
 	FVector CachedMeshRelativeLocation = FVector::ZeroVector;
 	FTimerHandle ReActivateHandle;
+
+	// Only the server changes this, push-based so a dormant pickup costs nothing to compare
+	UPROPERTY(ReplicatedUsing = OnRep_PickedUp)
 	bool bPickedUp = false;
 
 private:
+	// The bobbing and spinning is all the pickup ticks for, so dedicated servers don't tick it
+	bool ShouldAnimateMesh() const;
+
+	UFUNCTION()
+	void OnRep_PickedUp();
+	void SetPickedUp(bool bNewPickedUp);
+	void ApplyPickedUpState();
+
 	UFUNCTION()
 	void ReActivatePickup();
 	UFUNCTION()
@@ -4,6 +4,7 @@
 #include "Kismet/GameplayStatics.h"
 #include "DrawDebugHelpers.h"
 #include "Player/FGPlayer.h"
+#include "Debug/FGNetStats.h"
 
 void AFGRocket::SetRocketVisibility(bool bVisible)
 {
@@ -23,6 +24,8 @@ AFGRocket::AFGRocket()
 	MeshComponent->SetCollisionProfileName(TEXT("NoCollision"));
 
 	SetReplicates(true);
+	// Pooled rockets have no state to replicate until they are fired
+	NetDormancy = DORM_DormantAll;
 }
 
 void AFGRocket::BeginPlay()
@@ -38,15 +41,25 @@ void AFGRocket::BeginPlay()
 
 void AFGRocket::Tick(float DeltaTime)
 {
+	SCOPE_CYCLE_COUNTER(STAT_FGRocketTick);
+	CSV_SCOPED_TIMING_STAT(FGNet, RocketTick);
+
 	Super::Tick(DeltaTime);
 
 	LifeTimeElapsed -= DeltaTime;
 	DistanceMoved += MovementVelocity * DeltaTime;
 
+	if (CatchUpDistanceRemaining > 0.0f)
+	{
+		const float CatchUpDistance = FMath::Min(CatchUpDistanceRemaining, CatchUpSpeed * DeltaTime);
+		CatchUpDistanceRemaining -= CatchUpDistance;
+		DistanceMoved += CatchUpDistance;
+	}
+
 	FacingRotationStart = FQuat::Slerp(FacingRotationStart.ToOrientationQuat(), FacingRotationCorrection, 0.9f * DeltaTime).Vector();
 
-#if !UE_BUILD_SHIPPING
-	if (bDebugDrawCorrection)
+#if !UE_BUILD_SHIPPING && !UE_SERVER
+	if (bDebugDrawCorrection && !IsNetMode(NM_DedicatedServer))
 	{
 		const float ArrowLength = 3000.0f;
 		const float ArrowSize = 50.0f;
@@ -59,24 +72,50 @@ void AFGRocket::Tick(float DeltaTime)
 
 	SetActorLocation(NewLocation);
 
-	FHitResult Hit;
-	const FVector StartLoc = NewLocation;
-	const FVector EndLoc = StartLoc + FacingRotationStart * 100.0f;
-	GetWorld()->LineTraceSingleByChannel(Hit, StartLoc, EndLoc, ECC_Visibility, CachedCollisionQueryParams);
-
-	if (Hit.bBlockingHit)
+	if (ShouldTraceHits())
 	{
-		if (AFGPlayer* Player = Cast<AFGPlayer>(Hit.Actor))
+		FHitResult Hit;
+		const FVector StartLoc = NewLocation;
+		const FVector EndLoc = StartLoc + FacingRotationStart * 100.0f;
+		GetWorld()->LineTraceSingleByChannel(Hit, StartLoc, EndLoc, ECC_Visibility, CachedCollisionQueryParams);
+
+		if (Hit.bBlockingHit)
 		{
-			Player->HitPlayerWithRocket(this);
+			if (HasAuthority())
+			{
+				if (AFGPlayer* Player = Cast<AFGPlayer>(Hit.Actor))
+				{
+					Player->HitPlayerWithRocket(this);
+				}
+
+				FFGScopedRPCStat RPCStat(EFGNetRPCType::Fire, GetNetDriver());
+				Multicast_Explode(Hit.ImpactPoint);
+			}
+			else
+			{
+				// The server's explosion will find this rocket already free
+				Explode(Hit.ImpactPoint);
+			}
+			return;
 		}
-		Explode();
 	}
 
+	// Every machine runs out the lifetime on its own
 	if (LifeTimeElapsed < 0.0f)
 	{
-		Explode();
+		Explode(GetActorLocation());
+	}
+}
+
+bool AFGRocket::ShouldTraceHits() const
+{
+	if (HasAuthority())
+	{
+		return true;
 	}
+
+	const APawn* OwnerPawn = Cast<APawn>(GetOwner());
+	return bPredictOwnerHits && OwnerPawn != nullptr && OwnerPawn->IsLocallyControlled();
 }
 
 void AFGRocket::StartMoving(const FVector& Forward, const FVector& InStartLocation)
@@ -90,7 +129,13 @@ void AFGRocket::StartMoving(const FVector& Forward, const FVector& InStartLocati
 	SetRocketVisibility(true);
 	LifeTimeElapsed = LifeTime;
 	DistanceMoved = 0.0f;
+	CatchUpDistanceRemaining = 0.0f;
 	OriginalFacingDirection = FacingRotationStart;
+
+	if (HasAuthority())
+	{
+		SetNetDormancy(DORM_Awake);
+	}
 }
 
 void AFGRocket::ApplyCorrection(const FVector& Forward)
@@ -98,19 +143,52 @@ void AFGRocket::ApplyCorrection(const FVector& Forward)
 	FacingRotationCorrection = Forward.ToOrientationQuat();
 }
 
-void AFGRocket::Explode()
+void AFGRocket::FastForward(float Seconds)
+{
+	Seconds = FMath::Min(Seconds, LifeTime);
+	LifeTimeElapsed -= Seconds;
+
+	const float Distance = MovementVelocity * Seconds;
+
+	if (CatchUpTime > 0.0f)
+	{
+		CatchUpDistanceRemaining = Distance;
+		CatchUpSpeed = Distance / CatchUpTime;
+	}
+	else
+	{
+		DistanceMoved += Distance;
+		SetActorLocation(RocketStartLocation + FacingRotationStart * DistanceMoved);
+	}
+}
+
+void AFGRocket::Explode(const FVector& ExplosionLocation)
 {
-	if (Explosion != nullptr)
+	if (Explosion != nullptr && !IsNetMode(NM_DedicatedServer))
 	{
-		UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), Explosion, GetActorLocation(), GetActorRotation(), true);
+		UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), Explosion, ExplosionLocation, GetActorRotation(), true);
 	}
 
 	MakeFree();
 }
 
+void AFGRocket::Multicast_Explode_Implementation(const FVector_NetQuantize& ImpactPoint)
+{
+	// Already free when the lifetime ran out here first, or the owner predicted the hit
+	if (!bIsFree)
+	{
+		Explode(ImpactPoint);
+	}
+}
+
 void AFGRocket::MakeFree()
 {
 	bIsFree = true;
 	SetActorTickEnabled(false);
 	SetRocketVisibility(false);
+
+	if (HasAuthority())
+	{
+		SetNetDormancy(DORM_DormantAll);
+	}
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "GameFramework/Actor.h"
+#include "Engine/NetSerialization.h"
 #include "FGRocket.generated.h"
 
 class UStaticMeshComponent;
@@ -20,6 +21,12 @@ private:
 	UStaticMeshComponent* MeshComponent = nullptr;
 	UPROPERTY(EditAnywhere, Category = Debug)
 	bool bDebugDrawCorrection = true;
+	// Lets the client that fired the rocket trace for hits and explode it straight away. The hit still only counts on the server.
+	UPROPERTY(EditAnywhere, Category = Network)
+	bool bPredictOwnerHits = false;
+	// Time a rocket that started late spends catching up with the server's, zero jumps it there straight away
+	UPROPERTY(EditAnywhere, Category = Network, meta = (ClampMin = 0.0))
+	float CatchUpTime = 0.1f;
 
 	FVector OriginalFacingDirection = FVector::ZeroVector;
 	FVector FacingRotationStart = FVector::ZeroVector;
@@ -31,9 +38,13 @@ private:
 	bool bIsFree = true;
 	float LifeTimeElapsed = 0.0f;
 	float DistanceMoved = 0.0f;
+	float CatchUpDistanceRemaining = 0.0f;
+	float CatchUpSpeed = 0.0f;
 
 private:
 	void SetRocketVisibility(bool bVisible);
+	// Only the server's hits count, so other machines fly the rocket without tracing until told where it exploded
+	bool ShouldTraceHits() const;
 
 public:
 	AFGRocket();
@@ -43,9 +54,15 @@ public:
 
 	void StartMoving(const FVector& Forward, const FVector& InStartLocation);
 	void ApplyCorrection(const FVector& Forward);
+	// Advances a rocket that was just started by time it should already have been flying
+	void FastForward(float Seconds);
 
 	bool IsFree() const { return bIsFree; }
 
-	void Explode();
+	// Plays the explosion here and returns the rocket to the pool
+	void Explode(const FVector& ExplosionLocation);
 	void MakeFree();
+
+	UFUNCTION(NetMulticast, Reliable)
+	void Multicast_Explode(const FVector_NetQuantize& ImpactPoint);
 };
\ No newline at end of file
@@ -2,5 +2,43 @@
 
 #include "FG_Net.h"
 #include "Modules/ModuleManager.h"
+#include "Containers/Ticker.h"
+#include "Debug/FGNetStats.h"
+#include "Debug/FGLoadTestRecorder.h"
+#include "Debug/FGNetScenario.h"
+#include "Debug/FGCorrectionTelemetry.h"
+#include "Debug/FGNetRecorder.h"
+#include "Debug/FGNetReplay.h"
 
-IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, FG_Net, "FG_Net" );
+class FFGNetModule : public FDefaultGameModuleImpl
+{
+public:
+	virtual void StartupModule() override
+	{
+		TickHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FFGNetModule::Tick));
+		FFGCorrectionTelemetry::Startup();
+	}
+
+	virtual void ShutdownModule() override
+	{
+		FTicker::GetCoreTicker().RemoveTicker(TickHandle);
+		FFGLoadTestRecorder::Shutdown();
+		FFGCorrectionTelemetry::Shutdown();
+		FFGNetRecorder::Stop();
+	}
+
+private:
+	bool Tick(float DeltaTime)
+	{
+		FFGNetStats::Tick(DeltaTime);
+		FFGLoadTestRecorder::Tick(DeltaTime);
+		FFGNetScenario::TickGlobal(DeltaTime);
+		FFGNetRecorder::Tick(DeltaTime);
+		FFGNetReplay::Tick(DeltaTime);
+		return true;
+	}
+
+	FDelegateHandle TickHandle;
+};
+
+IMPLEMENT_PRIMARY_GAME_MODULE( FFGNetModule, FG_Net, "FG_Net" );
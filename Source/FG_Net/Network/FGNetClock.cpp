@@ -0,0 +1,114 @@
+#include "FGNetClock.h"
+#include "Engine/World.h"
+#include "Engine/Engine.h"
+#include "HAL/PlatformTime.h"
+
+UFGNetClockSubsystem* UFGNetClockSubsystem::Get(const UObject* WorldContextObject)
+{
+	UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull);
+	return World != nullptr ? World->GetSubsystem<UFGNetClockSubsystem>() : nullptr;
+}
+
+void UFGNetClockSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	StartCycles = FPlatformTime::Cycles64();
+	SimulationTickRate = FMath::Max(SimulationTickRate, 1);
+	SlewRate = FMath::Clamp(SlewRate, 0.0f, 0.5f);
+
+	for (TPair<FFGNetTimeStamp, int64>& SentTimeStamp : SentTimeStamps)
+	{
+		SentTimeStamp = TPair<FFGNetTimeStamp, int64>(0, -1);
+	}
+}
+
+int64 UFGNetClockSubsystem::GetLocalTimeMicros() const
+{
+	return static_cast<int64>((FPlatformTime::Cycles64() - StartCycles) * FPlatformTime::GetSecondsPerCycle64() * 1000000.0);
+}
+
+int64 UFGNetClockSubsystem::GetNetworkTimeMicros() const
+{
+	if (IsAuthority())
+	{
+		return GetLocalTimeMicros();
+	}
+
+	UpdateOffset();
+	return GetLocalTimeMicros() + CurrentOffset;
+}
+
+bool UFGNetClockSubsystem::IsAuthority() const
+{
+	const UWorld* World = GetWorld();
+	return World == nullptr || World->GetNetMode() != NM_Client;
+}
+
+int64 UFGNetClockSubsystem::GetSimulationTick() const
+{
+	return GetNetworkTimeMicros() * SimulationTickRate / 1000000;
+}
+
+float UFGNetClockSubsystem::GetSimulationTickAlpha() const
+{
+	const int64 TickMicros = GetNetworkTimeMicros() * SimulationTickRate;
+	return static_cast<float>(TickMicros % 1000000) / 1000000.0f;
+}
+
+int64 UFGNetClockSubsystem::ExpandTimeStamp(FFGNetTimeStamp TimeStamp) const
+{
+	const int64 Reference = GetNetworkTimeMicros();
+	return Reference + static_cast<int32>(TimeStamp - static_cast<FFGNetTimeStamp>(Reference));
+}
+
+float UFGNetClockSubsystem::GetDeltaSeconds(FFGNetTimeStamp Later, FFGNetTimeStamp Earlier)
+{
+	return static_cast<int32>(Later - Earlier) / 1000000.0f;
+}
+
+FFGNetTimeStamp UFGNetClockSubsystem::RecordSentTimeStamp()
+{
+	const int64 LocalTime = GetLocalTimeMicros();
+	const FFGNetTimeStamp TimeStamp = GetNetworkTimeStamp();
+
+	SentTimeStamps[SentTimeStampIndex] = TPair<FFGNetTimeStamp, int64>(TimeStamp, LocalTime);
+	SentTimeStampIndex = (SentTimeStampIndex + 1) % NumSentTimeStamps;
+	return TimeStamp;
+}
+
+bool UFGNetClockSubsystem::FindLocalSendTime(FFGNetTimeStamp TimeStamp, int64& OutLocalTimeMicros) const
+{
+	for (const TPair<FFGNetTimeStamp, int64>& SentTimeStamp : SentTimeStamps)
+	{
+		if (SentTimeStamp.Value >= 0 && SentTimeStamp.Key == TimeStamp)
+		{
+			OutLocalTimeMicros = SentTimeStamp.Value;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void UFGNetClockSubsystem::SetTargetOffset(int64 OffsetMicros)
+{
+	UpdateOffset();
+	TargetOffset = OffsetMicros;
+
+	if (!bHasOffset || FMath::Abs(TargetOffset - CurrentOffset) > StepThresholdMicros)
+	{
+		UE_LOG(LogTemp, Log, TEXT("FGNetClock: Stepping clock by %lld us"), TargetOffset - CurrentOffset);
+		CurrentOffset = TargetOffset;
+		bHasOffset = true;
+	}
+}
+
+void UFGNetClockSubsystem::UpdateOffset() const
+{
+	const int64 LocalTime = GetLocalTimeMicros();
+	const int64 MaxAdjustment = static_cast<int64>((LocalTime - LastSlewLocalTime) * SlewRate);
+	LastSlewLocalTime = LocalTime;
+
+	CurrentOffset += FMath::Clamp(TargetOffset - CurrentOffset, -MaxAdjustment, MaxAdjustment);
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "FGNetClock.generated.h"
+
+// Low 32 bits of a network time in microseconds, as sent in RPCs. Wraps every ~71 minutes, so only compare them with
+// UFGNetClockSubsystem::GetDeltaSeconds or ExpandTimeStamp, which are correct for stamps up to ~35 minutes apart.
+typedef uint32 FFGNetTimeStamp;
+
+// Network clock shared by the server and its clients. The server's clock is the reference, clients follow it using the
+// offset estimated by their FFGRttEstimator and slew towards new estimates instead of jumping, so time never runs backwards.
+// Times are kept as integer microseconds, so precision doesn't degrade with uptime.
+UCLASS(Config = Engine)
+class FG_NET_API UFGNetClockSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+public:
+	static UFGNetClockSubsystem* Get(const UObject* WorldContextObject);
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	// Monotonic time on this machine since the subsystem started
+	int64 GetLocalTimeMicros() const;
+	int64 GetNetworkTimeMicros() const;
+	double GetNetworkTimeSeconds() const { return GetNetworkTimeMicros() / 1000000.0; }
+	FFGNetTimeStamp GetNetworkTimeStamp() const { return static_cast<FFGNetTimeStamp>(GetNetworkTimeMicros()); }
+
+	// Network time in whole simulation ticks, and how far into the current tick it is
+	int64 GetSimulationTick() const;
+	float GetSimulationTickAlpha() const;
+	int32 GetSimulationTickRate() const { return SimulationTickRate; }
+	float GetSimulationTickDuration() const { return 1.0f / SimulationTickRate; }
+
+	// Network time in microseconds closest to now that has the given low 32 bits
+	int64 ExpandTimeStamp(FFGNetTimeStamp TimeStamp) const;
+	static float GetDeltaSeconds(FFGNetTimeStamp Later, FFGNetTimeStamp Earlier);
+
+	// Client side clock discipline. Sent time stamps are remembered so echoes of them can be turned back into local time.
+	FFGNetTimeStamp RecordSentTimeStamp();
+	bool FindLocalSendTime(FFGNetTimeStamp TimeStamp, int64& OutLocalTimeMicros) const;
+	void SetTargetOffset(int64 OffsetMicros);
+
+	// Net mode isn't known yet when subsystems are created, so this is checked when asked
+	bool IsAuthority() const;
+	bool IsSynchronized() const { return bHasOffset || IsAuthority(); }
+	int64 GetOffsetMicros() const { UpdateOffset(); return CurrentOffset; }
+
+	UPROPERTY(Config)
+	int32 SimulationTickRate = 60;
+
+	// Fraction of elapsed time the clock may be sped up or slowed down by while catching up with a new offset
+	UPROPERTY(Config)
+	float SlewRate = 0.05f;
+
+	// Offset errors larger than this are corrected by jumping, e.g. on the first estimate
+	UPROPERTY(Config)
+	int32 StepThresholdMicros = 250000;
+
+private:
+	void UpdateOffset() const;
+
+	static constexpr int32 NumSentTimeStamps = 64;
+
+	TPair<FFGNetTimeStamp, int64> SentTimeStamps[NumSentTimeStamps];
+	int32 SentTimeStampIndex = 0;
+
+	uint64 StartCycles = 0;
+	mutable int64 CurrentOffset = 0;
+	mutable int64 LastSlewLocalTime = 0;
+	int64 TargetOffset = 0;
+	bool bHasOffset = false;
+};
@@ -0,0 +1,215 @@
+#include "FGNetQuantize.h"
+
+namespace
+{
+	uint32 GetMaxPacked(int32 NumBits)
+	{
+		check(NumBits > 0 && NumBits < 32);
+		return (1u << NumBits) - 1;
+	}
+
+	float SignNotZero(float Value)
+	{
+		return Value >= 0.0f ? 1.0f : -1.0f;
+	}
+
+	// Folds the lower hemisphere of the octahedron over the upper one, the same operation both ways
+	void FoldOctahedron(float& U, float& V)
+	{
+		const float OldU = U;
+		U = (1.0f - FMath::Abs(V)) * SignNotZero(OldU);
+		V = (1.0f - FMath::Abs(OldU)) * SignNotZero(V);
+	}
+}
+
+uint32 FFGNetQuantize::QuantizeYaw(float Yaw, int32 NumBits)
+{
+	// Masking wraps negative and past 360 yaws for free
+	return static_cast<uint32>(FMath::RoundToInt(Yaw * static_cast<float>(1u << NumBits) / 360.0f)) & GetMaxPacked(NumBits);
+}
+
+float FFGNetQuantize::DequantizeYaw(uint32 Packed, int32 NumBits)
+{
+	return static_cast<float>(Packed & GetMaxPacked(NumBits)) * 360.0f / static_cast<float>(1u << NumBits);
+}
+
+uint32 FFGNetQuantize::QuantizeBoundedFloat(float Value, float Bound, int32 NumBits)
+{
+	const uint32 MaxPacked = GetMaxPacked(NumBits);
+	const float Alpha = (FMath::Clamp(Value, -Bound, Bound) + Bound) / (2.0f * Bound);
+	return FMath::Min(static_cast<uint32>(FMath::RoundToInt(Alpha * MaxPacked)), MaxPacked);
+}
+
+float FFGNetQuantize::DequantizeBoundedFloat(uint32 Packed, float Bound, int32 NumBits)
+{
+	const uint32 MaxPacked = GetMaxPacked(NumBits);
+	return static_cast<float>(Packed & MaxPacked) / MaxPacked * 2.0f * Bound - Bound;
+}
+
+uint32 FFGNetQuantize::QuantizeQuat(const FQuat& Quat, int32 BitsPerComponent)
+{
+	check(BitsPerComponent <= MaxQuatBitsPerComponent);
+
+	const FQuat Normalized = Quat.GetNormalized();
+	const float Components[4] = { Normalized.X, Normalized.Y, Normalized.Z, Normalized.W };
+
+	uint32 LargestIndex = 0;
+	for (uint32 Index = 1; Index < 4; ++Index)
+	{
+		if (FMath::Abs(Components[Index]) > FMath::Abs(Components[LargestIndex]))
+		{
+			LargestIndex = Index;
+		}
+	}
+
+	// Q and -Q are the same rotation, so flip it to make the dropped component positive and leave its sign implied
+	const float Sign = SignNotZero(Components[LargestIndex]);
+
+	uint32 Packed = LargestIndex;
+	int32 Shift = 2;
+	for (uint32 Index = 0; Index < 4; ++Index)
+	{
+		if (Index != LargestIndex)
+		{
+			Packed |= QuantizeBoundedFloat(Components[Index] * Sign, HALF_SQRT_2, BitsPerComponent) << Shift;
+			Shift += BitsPerComponent;
+		}
+	}
+
+	return Packed;
+}
+
+FQuat FFGNetQuantize::DequantizeQuat(uint32 Packed, int32 BitsPerComponent)
+{
+	check(BitsPerComponent <= MaxQuatBitsPerComponent);
+
+	const uint32 LargestIndex = Packed & 3;
+	float Components[4];
+	float SumSquared = 0.0f;
+	int32 Shift = 2;
+	for (uint32 Index = 0; Index < 4; ++Index)
+	{
+		if (Index != LargestIndex)
+		{
+			Components[Index] = DequantizeBoundedFloat(Packed >> Shift, HALF_SQRT_2, BitsPerComponent);
+			SumSquared += FMath::Square(Components[Index]);
+			Shift += BitsPerComponent;
+		}
+	}
+
+	Components[LargestIndex] = FMath::Sqrt(FMath::Max(1.0f - SumSquared, 0.0f));
+	return FQuat(Components[0], Components[1], Components[2], Components[3]).GetNormalized();
+}
+
+uint32 FFGNetQuantize::QuantizeUnitVector(const FVector& Direction, int32 BitsPerAxis)
+{
+	check(BitsPerAxis <= MaxUnitVectorBitsPerAxis);
+
+	const FVector Normalized = Direction.GetSafeNormal(SMALL_NUMBER, FVector::ForwardVector);
+	const float L1Norm = FMath::Abs(Normalized.X) + FMath::Abs(Normalized.Y) + FMath::Abs(Normalized.Z);
+	float U = Normalized.X / L1Norm;
+	float V = Normalized.Y / L1Norm;
+
+	if (Normalized.Z < 0.0f)
+	{
+		FoldOctahedron(U, V);
+	}
+
+	return QuantizeBoundedFloat(U, 1.0f, BitsPerAxis) | (QuantizeBoundedFloat(V, 1.0f, BitsPerAxis) << BitsPerAxis);
+}
+
+FVector FFGNetQuantize::DequantizeUnitVector(uint32 Packed, int32 BitsPerAxis)
+{
+	check(BitsPerAxis <= MaxUnitVectorBitsPerAxis);
+
+	float U = DequantizeBoundedFloat(Packed, 1.0f, BitsPerAxis);
+	float V = DequantizeBoundedFloat(Packed >> BitsPerAxis, 1.0f, BitsPerAxis);
+	const float Z = 1.0f - FMath::Abs(U) - FMath::Abs(V);
+
+	if (Z < 0.0f)
+	{
+		FoldOctahedron(U, V);
+	}
+
+	return FVector(U, V, Z).GetSafeNormal(SMALL_NUMBER, FVector::ForwardVector);
+}
+
+void FFGNetQuantize::SerializePacked(FArchive& Ar, uint32& Packed, int32 NumBits)
+{
+	check(NumBits > 0 && NumBits <= 32);
+
+	if (Ar.IsLoading())
+	{
+		Packed = 0;
+	}
+
+	Ar.SerializeBits(&Packed, NumBits);
+}
+
+void FFGNetQuantize::SerializeYaw(FArchive& Ar, float& Yaw, int32 NumBits)
+{
+	uint32 Packed = Ar.IsSaving() ? QuantizeYaw(Yaw, NumBits) : 0;
+	SerializePacked(Ar, Packed, NumBits);
+
+	if (Ar.IsLoading())
+	{
+		Yaw = DequantizeYaw(Packed, NumBits);
+	}
+}
+
+void FFGNetQuantize::SerializeQuat(FArchive& Ar, FQuat& Quat, int32 BitsPerComponent)
+{
+	uint32 Packed = Ar.IsSaving() ? QuantizeQuat(Quat, BitsPerComponent) : 0;
+	SerializePacked(Ar, Packed, 2 + 3 * BitsPerComponent);
+
+	if (Ar.IsLoading())
+	{
+		Quat = DequantizeQuat(Packed, BitsPerComponent);
+	}
+}
+
+void FFGNetQuantize::SerializeUnitVector(FArchive& Ar, FVector& Direction, int32 BitsPerAxis)
+{
+	uint32 Packed = Ar.IsSaving() ? QuantizeUnitVector(Direction, BitsPerAxis) : 0;
+	SerializePacked(Ar, Packed, 2 * BitsPerAxis);
+
+	if (Ar.IsLoading())
+	{
+		Direction = DequantizeUnitVector(Packed, BitsPerAxis);
+	}
+}
+
+void FFGNetQuantize::SerializeBoundedVector(FArchive& Ar, FVector& Vector, float Bound, int32 BitsPerComponent)
+{
+	for (int32 Axis = 0; Axis < 3; ++Axis)
+	{
+		uint32 Packed = Ar.IsSaving() ? QuantizeBoundedFloat(Vector[Axis], Bound, BitsPerComponent) : 0;
+		SerializePacked(Ar, Packed, BitsPerComponent);
+
+		if (Ar.IsLoading())
+		{
+			Vector[Axis] = DequantizeBoundedFloat(Packed, Bound, BitsPerComponent);
+		}
+	}
+}
+
+bool FFGNetQuantizedYaw::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	FFGNetQuantize::SerializeYaw(Ar, Yaw, NumBits);
+	bOutSuccess = true;
+	return true;
+}
+
+bool FFGNetQuantizedQuat::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	FFGNetQuantize::SerializeQuat(Ar, Quat, BitsPerComponent);
+	bOutSuccess = true;
+	return true;
+}
+
+bool FFGNetQuantizedDirection::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	FFGNetQuantize::SerializeUnitVector(Ar, Direction, BitsPerAxis);
+	bOutSuccess = true;
+	return true;
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FGNetQuantize.generated.h"
+
+// Packs orientations and vectors into a handful of bits for RPC parameters and NetSerialize implementations.
+// Quantize and Dequantize work on plain integers, the Serialize functions write exactly the stated number of bits to an archive.
+struct FG_NET_API FFGNetQuantize
+{
+	static constexpr int32 MaxQuatBitsPerComponent = 10;
+	static constexpr int32 MaxUnitVectorBitsPerAxis = 16;
+
+	// Degrees, comes back in [0, 360). Worst case error is 180 / 2^NumBits degrees, 0.7 at 8 bits and 0.003 at 16.
+	static uint32 QuantizeYaw(float Yaw, int32 NumBits);
+	static float DequantizeYaw(uint32 Packed, int32 NumBits);
+
+	// Clamped to [-Bound, Bound], worst case error Bound / (2^NumBits - 1)
+	static uint32 QuantizeBoundedFloat(float Value, float Bound, int32 NumBits);
+	static float DequantizeBoundedFloat(uint32 Packed, float Bound, int32 NumBits);
+
+	// Smallest three: the largest component is dropped and rebuilt from the other three, which all fit in [-1/sqrt(2), 1/sqrt(2)].
+	// Costs 2 + 3 * BitsPerComponent bits. Worst case rotation error is 0.53 degrees at 9 bits and 0.27 at 10.
+	static uint32 QuantizeQuat(const FQuat& Quat, int32 BitsPerComponent);
+	static FQuat DequantizeQuat(uint32 Packed, int32 BitsPerComponent);
+
+	// Octahedral mapping, 2 * BitsPerAxis bits. Worst case error is 1 degree at 8 bits per axis, 0.06 at 12 and 0.004 at 16.
+	static uint32 QuantizeUnitVector(const FVector& Direction, int32 BitsPerAxis);
+	static FVector DequantizeUnitVector(uint32 Packed, int32 BitsPerAxis);
+
+	static void SerializeYaw(FArchive& Ar, float& Yaw, int32 NumBits);
+	static void SerializeQuat(FArchive& Ar, FQuat& Quat, int32 BitsPerComponent);
+	static void SerializeUnitVector(FArchive& Ar, FVector& Direction, int32 BitsPerAxis);
+	static void SerializeBoundedVector(FArchive& Ar, FVector& Vector, float Bound, int32 BitsPerComponent);
+
+private:
+	static void SerializePacked(FArchive& Ar, uint32& Packed, int32 NumBits);
+};
+
+// Yaw only orientation, 2 bytes on the wire
+USTRUCT()
+struct FG_NET_API FFGNetQuantizedYaw
+{
+	GENERATED_BODY()
+
+	static constexpr int32 NumBits = 16;
+
+	FFGNetQuantizedYaw() = default;
+	FFGNetQuantizedYaw(float InYaw) : Yaw(InYaw) {}
+
+	UPROPERTY()
+	float Yaw = 0.0f;
+
+	FRotator ToRotator() const { return FRotator(0.0f, Yaw, 0.0f); }
+
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FFGNetQuantizedYaw> : public TStructOpsTypeTraitsBase2<FFGNetQuantizedYaw>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
+
+// Full orientation, 4 bytes on the wire
+USTRUCT()
+struct FG_NET_API FFGNetQuantizedQuat
+{
+	GENERATED_BODY()
+
+	static constexpr int32 BitsPerComponent = FFGNetQuantize::MaxQuatBitsPerComponent;
+
+	FFGNetQuantizedQuat() = default;
+	FFGNetQuantizedQuat(const FQuat& InQuat) : Quat(InQuat) {}
+
+	UPROPERTY()
+	FQuat Quat = FQuat::Identity;
+
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FFGNetQuantizedQuat> : public TStructOpsTypeTraitsBase2<FFGNetQuantizedQuat>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
+
+// Unit direction, 3 bytes on the wire
+USTRUCT()
+struct FG_NET_API FFGNetQuantizedDirection
+{
+	GENERATED_BODY()
+
+	static constexpr int32 BitsPerAxis = 12;
+
+	FFGNetQuantizedDirection() = default;
+	FFGNetQuantizedDirection(const FVector& InDirection) : Direction(InDirection) {}
+
+	UPROPERTY()
+	FVector Direction = FVector::ForwardVector;
+
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FFGNetQuantizedDirection> : public TStructOpsTypeTraitsBase2<FFGNetQuantizedDirection>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
@@ -0,0 +1,243 @@
+#include "FGReplicationGraph.h"
+#include "Engine/LevelScriptActor.h"
+#include "Engine/NetDriver.h"
+#include "GameFramework/Info.h"
+#include "GameFramework/PlayerController.h"
+#include "UObject/UObjectIterator.h"
+#include "../Player/FGPlayer.h"
+#include "../FGPickup.h"
+#include "../FGRocket.h"
+
+void UFGReplicationGraph::InitGlobalActorClassSettings()
+{
+	Super::InitGlobalActorClassSettings();
+
+	ClassRepNodePolicies.Set(AReplicationGraphDebugActor::StaticClass(), EFGClassRepNodeMapping::NotRouted);
+	ClassRepNodePolicies.Set(ALevelScriptActor::StaticClass(), EFGClassRepNodeMapping::NotRouted);
+	ClassRepNodePolicies.Set(APlayerController::StaticClass(), EFGClassRepNodeMapping::NotRouted);
+	ClassRepNodePolicies.Set(AInfo::StaticClass(), EFGClassRepNodeMapping::RelevantAllConnections);
+	ClassRepNodePolicies.Set(AFGPlayer::StaticClass(), EFGClassRepNodeMapping::Spatialize_Dynamic);
+	ClassRepNodePolicies.Set(AFGPickup::StaticClass(), EFGClassRepNodeMapping::Spatialize_Static);
+	ClassRepNodePolicies.Set(AFGRocket::StaticClass(), EFGClassRepNodeMapping::OwnerDependent);
+
+	const float ServerMaxTickRate = NetDriver != nullptr ? NetDriver->NetServerMaxTickRate : 30.0f;
+
+	for (TObjectIterator<UClass> It; It; ++It)
+	{
+		UClass* Class = *It;
+		const AActor* ActorCDO = Cast<AActor>(Class->GetDefaultObject());
+
+		if (ActorCDO == nullptr || !ActorCDO->GetIsReplicated())
+		{
+			continue;
+		}
+
+		// Skip blueprint compilation leftovers
+		if (Class->GetName().StartsWith(TEXT("SKEL_")) || Class->GetName().StartsWith(TEXT("REINST_")))
+		{
+			continue;
+		}
+
+		if (ClassRepNodePolicies.Get(Class) == nullptr)
+		{
+			ClassRepNodePolicies.Set(Class, GetDefaultMappingPolicy(ActorCDO));
+		}
+
+		const EFGClassRepNodeMapping Mapping = GetMappingPolicy(Class);
+		const bool bSpatialize = Mapping == EFGClassRepNodeMapping::Spatialize_Static
+			|| Mapping == EFGClassRepNodeMapping::Spatialize_Dynamic
+			|| Mapping == EFGClassRepNodeMapping::Spatialize_Dormancy;
+
+		FClassReplicationInfo ClassInfo;
+		ClassInfo.ReplicationPeriodFrame = GetReplicationPeriodFrame(ActorCDO, ServerMaxTickRate, 1.0f);
+
+		if (bSpatialize)
+		{
+			ClassInfo.SetCullDistanceSquared(ActorCDO->NetCullDistanceSquared);
+		}
+
+		GlobalActorReplicationInfoMap.SetClassInfo(Class, ClassInfo);
+		ReplicatedClasses.Add(Class);
+	}
+}
+
+void UFGReplicationGraph::SetReplicationRates(float ServerTickRate, float NetUpdateFrequencyScale)
+{
+	for (UClass* Class : ReplicatedClasses)
+	{
+		GlobalActorReplicationInfoMap.GetClassInfo(Class).ReplicationPeriodFrame = GetReplicationPeriodFrame(Class->GetDefaultObject<AActor>(), ServerTickRate, NetUpdateFrequencyScale);
+	}
+
+	// Actors take a copy of their class settings when they are added
+	for (auto It = GlobalActorReplicationInfoMap.CreateActorMapIterator(); It; ++It)
+	{
+		if (const AActor* Actor = It.Key())
+		{
+			It.Value()->Settings.ReplicationPeriodFrame = GetReplicationPeriodFrame(Actor->GetClass()->GetDefaultObject<AActor>(), ServerTickRate, NetUpdateFrequencyScale);
+		}
+	}
+}
+
+uint32 UFGReplicationGraph::GetReplicationPeriodFrame(const AActor* ActorCDO, float ServerTickRate, float NetUpdateFrequencyScale)
+{
+	const float NetUpdateFrequency = FMath::Max(ActorCDO->NetUpdateFrequency * NetUpdateFrequencyScale, KINDA_SMALL_NUMBER);
+	return FMath::Max<uint32>(FMath::RoundToInt(ServerTickRate / NetUpdateFrequency), 1);
+}
+
+void UFGReplicationGraph::InitGlobalGraphNodes()
+{
+	GridNode = CreateNewNode<UReplicationGraphNode_GridSpatialization2D>();
+	GridNode->CellSize = GridCellSize;
+	GridNode->SpatialBias = FVector2D(SpatialBiasX, SpatialBiasY);
+
+	if (bDisableSpatialRebuilding)
+	{
+		GridNode->AddSpatialRebuildBlacklistClass(AActor::StaticClass());
+	}
+
+	AddGlobalGraphNode(GridNode);
+
+	AlwaysRelevantNode = CreateNewNode<UReplicationGraphNode_ActorList>();
+	AddGlobalGraphNode(AlwaysRelevantNode);
+}
+
+void UFGReplicationGraph::InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection)
+{
+	Super::InitConnectionGraphNodes(RepGraphConnection);
+
+	UFGReplicationGraphNode_AlwaysRelevant_ForConnection* AlwaysRelevantForConnectionNode = CreateNewNode<UFGReplicationGraphNode_AlwaysRelevant_ForConnection>();
+	AddConnectionGraphNode(AlwaysRelevantForConnectionNode, RepGraphConnection);
+}
+
+void UFGReplicationGraph::RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo)
+{
+	switch (GetMappingPolicy(ActorInfo.Class))
+	{
+	case EFGClassRepNodeMapping::RelevantAllConnections:
+		AlwaysRelevantNode->NotifyAddNetworkActor(ActorInfo);
+		break;
+	case EFGClassRepNodeMapping::Spatialize_Static:
+		GridNode->AddActor_Static(ActorInfo, GlobalInfo);
+		break;
+	case EFGClassRepNodeMapping::Spatialize_Dynamic:
+		GridNode->AddActor_Dynamic(ActorInfo, GlobalInfo);
+		break;
+	case EFGClassRepNodeMapping::Spatialize_Dormancy:
+		GridNode->AddActor_Dormancy(ActorInfo, GlobalInfo);
+		break;
+	case EFGClassRepNodeMapping::OwnerDependent:
+		AddOwnerDependentActor(ActorInfo.Actor);
+		break;
+	default:
+		break;
+	}
+}
+
+void UFGReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo)
+{
+	switch (GetMappingPolicy(ActorInfo.Class))
+	{
+	case EFGClassRepNodeMapping::RelevantAllConnections:
+		AlwaysRelevantNode->NotifyRemoveNetworkActor(ActorInfo);
+		break;
+	case EFGClassRepNodeMapping::Spatialize_Static:
+		GridNode->RemoveActor_Static(ActorInfo);
+		break;
+	case EFGClassRepNodeMapping::Spatialize_Dynamic:
+		GridNode->RemoveActor_Dynamic(ActorInfo);
+		break;
+	case EFGClassRepNodeMapping::Spatialize_Dormancy:
+		GridNode->RemoveActor_Dormancy(ActorInfo);
+		break;
+	case EFGClassRepNodeMapping::OwnerDependent:
+		RemoveOwnerDependentActor(ActorInfo.Actor);
+		break;
+	default:
+		break;
+	}
+}
+
+EFGClassRepNodeMapping UFGReplicationGraph::GetMappingPolicy(UClass* Class)
+{
+	const EFGClassRepNodeMapping* Policy = ClassRepNodePolicies.Get(Class);
+	return Policy != nullptr ? *Policy : EFGClassRepNodeMapping::NotRouted;
+}
+
+EFGClassRepNodeMapping UFGReplicationGraph::GetDefaultMappingPolicy(const AActor* ActorCDO) const
+{
+	if (ActorCDO->bOnlyRelevantToOwner)
+	{
+		return EFGClassRepNodeMapping::NotRouted;
+	}
+
+	if (ActorCDO->bAlwaysRelevant)
+	{
+		return EFGClassRepNodeMapping::RelevantAllConnections;
+	}
+
+	if (ActorCDO->NetDormancy != DORM_Never && ActorCDO->NetDormancy != DORM_Awake)
+	{
+		return EFGClassRepNodeMapping::Spatialize_Dormancy;
+	}
+
+	return ActorCDO->IsReplicatingMovement() ? EFGClassRepNodeMapping::Spatialize_Dynamic : EFGClassRepNodeMapping::Spatialize_Static;
+}
+
+void UFGReplicationGraph::AddOwnerDependentActor(AActor* Actor)
+{
+	AActor* OwnerActor = Actor->GetOwner();
+
+	// Without an owner there is nothing to follow, so fall back to the grid
+	if (OwnerActor == nullptr)
+	{
+		GridNode->AddActor_Dynamic(FNewReplicatedActorInfo(Actor), GlobalActorReplicationInfoMap.Get(Actor));
+		return;
+	}
+
+	FGlobalActorReplicationInfo& OwnerInfo = GlobalActorReplicationInfoMap.Get(OwnerActor);
+	OwnerInfo.DependentActorList.PrepareForWrite();
+	OwnerInfo.DependentActorList.ConditionalAdd(Actor);
+}
+
+void UFGReplicationGraph::RemoveOwnerDependentActor(AActor* Actor)
+{
+	AActor* OwnerActor = Actor->GetOwner();
+
+	if (OwnerActor == nullptr)
+	{
+		GridNode->RemoveActor_Dynamic(FNewReplicatedActorInfo(Actor));
+		return;
+	}
+
+	if (FGlobalActorReplicationInfo* OwnerInfo = GlobalActorReplicationInfoMap.Find(OwnerActor))
+	{
+		OwnerInfo->DependentActorList.PrepareForWrite();
+		OwnerInfo->DependentActorList.Remove(Actor);
+	}
+}
+
+void UFGReplicationGraphNode_AlwaysRelevant_ForConnection::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
+{
+	Super::GatherActorListsForConnection(Params);
+
+	ViewerActors.PrepareForWrite();
+	ViewerActors.Reset();
+
+	for (const FNetViewer& Viewer : Params.Viewers)
+	{
+		ViewerActors.ConditionalAdd(Viewer.InViewer);
+		ViewerActors.ConditionalAdd(Viewer.ViewTarget);
+
+		if (const APlayerController* PlayerController = Cast<APlayerController>(Viewer.InViewer))
+		{
+			APawn* Pawn = PlayerController->GetPawn();
+
+			if (Pawn != nullptr && Pawn != Viewer.ViewTarget)
+			{
+				ViewerActors.Add(Pawn);
+			}
+		}
+	}
+
+	Params.OutGatheredReplicationLists.AddReplicationActorList(ViewerActors);
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "ReplicationGraph.h"
+#include "FGReplicationGraph.generated.h"
+
+class UReplicationGraphNode_GridSpatialization2D;
+class UReplicationGraphNode_ActorList;
+
+UENUM()
+enum class EFGClassRepNodeMapping : uint8
+{
+	NotRouted,				// Not routed to a global node, e.g. player controllers which are added per connection
+	RelevantAllConnections,	// Always relevant to every connection, e.g. game state and player states
+	Spatialize_Static,		// Spatialized actors that never move, e.g. pickups
+	Spatialize_Dynamic,		// Spatialized actors that move every frame, e.g. players
+	Spatialize_Dormancy,	// Spatialized actors that only move while awake
+	OwnerDependent,			// Replicated together with their owner, e.g. pooled rockets
+};
+
+UCLASS(Transient, Config = Engine)
+class FG_NET_API UFGReplicationGraph : public UReplicationGraph
+{
+	GENERATED_BODY()
+public:
+	virtual void InitGlobalActorClassSettings() override;
+	virtual void InitGlobalGraphNodes() override;
+	virtual void InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection) override;
+	virtual void RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo) override;
+	virtual void RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo) override;
+
+	// Replication periods are counted in frames, so they are recomputed when the server tick rate changes. Existing actors are updated too.
+	void SetReplicationRates(float ServerTickRate, float NetUpdateFrequencyScale);
+
+	UPROPERTY(Config)
+	float GridCellSize = 10000.0f;
+
+	UPROPERTY(Config)
+	float SpatialBiasX = -150000.0f;
+
+	UPROPERTY(Config)
+	float SpatialBiasY = -200000.0f;
+
+	UPROPERTY(Config)
+	bool bDisableSpatialRebuilding = true;
+
+	UPROPERTY()
+	UReplicationGraphNode_GridSpatialization2D* GridNode = nullptr;
+
+	UPROPERTY()
+	UReplicationGraphNode_ActorList* AlwaysRelevantNode = nullptr;
+
+private:
+	EFGClassRepNodeMapping GetMappingPolicy(UClass* Class);
+	EFGClassRepNodeMapping GetDefaultMappingPolicy(const AActor* ActorCDO) const;
+	static uint32 GetReplicationPeriodFrame(const AActor* ActorCDO, float ServerTickRate, float NetUpdateFrequencyScale);
+
+	void AddOwnerDependentActor(AActor* Actor);
+	void RemoveOwnerDependentActor(AActor* Actor);
+
+	TClassMap<EFGClassRepNodeMapping> ClassRepNodePolicies;
+
+	UPROPERTY()
+	TArray<UClass*> ReplicatedClasses;
+};
+
+// Keeps the connection's own controller and pawn relevant regardless of the grid
+UCLASS()
+class FG_NET_API UFGReplicationGraphNode_AlwaysRelevant_ForConnection : public UReplicationGraphNode_ActorList
+{
+	GENERATED_BODY()
+public:
+	virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
+
+private:
+	FActorRepListRefView ViewerActors;
+};
@@ -0,0 +1,67 @@
+#include "FGRttEstimator.h"
+
+namespace FGRttEstimator
+{
+	// Gains from RFC 6298 for the smoothed RTT and its variance, and RFC 3550 for jitter
+	static const float RttGain = 1.0f / 8.0f;
+	static const float VarianceGain = 1.0f / 4.0f;
+	static const float JitterGain = 1.0f / 16.0f;
+}
+
+void FFGRttEstimator::AddSample(int64 LocalSendTime, int64 RemoteReceiveTime, int64 RemoteSendTime, int64 LocalReceiveTime)
+{
+	using namespace FGRttEstimator;
+
+	// Differences are taken in whole microseconds before converting, so large clock values don't cost precision
+	const int64 RttMicros = FMath::Max<int64>((LocalReceiveTime - LocalSendTime) - (RemoteSendTime - RemoteReceiveTime), 0);
+	const int64 Offset = ((RemoteReceiveTime - LocalSendTime) + (RemoteSendTime - LocalReceiveTime)) / 2;
+	const float Rtt = RttMicros / 1000000.0f;
+
+	if (NumSamples == 0)
+	{
+		SmoothedRtt = Rtt;
+		RttVariance = Rtt * 0.5f;
+		Jitter = 0.0f;
+	}
+	else
+	{
+		RttVariance += (FMath::Abs(SmoothedRtt - Rtt) - RttVariance) * VarianceGain;
+		SmoothedRtt += (Rtt - SmoothedRtt) * RttGain;
+		Jitter += (FMath::Abs(Rtt - LastRtt) - Jitter) * JitterGain;
+	}
+
+	OffsetSamples[NumSamples % NumOffsetSamples] = { RttMicros, Offset };
+	NumSamples++;
+	LastRtt = Rtt;
+
+	const int32 NumValidOffsets = FMath::Min(NumSamples, NumOffsetSamples);
+	int32 BestIndex = 0;
+	for (int32 Index = 1; Index < NumValidOffsets; ++Index)
+	{
+		if (OffsetSamples[Index].Rtt < OffsetSamples[BestIndex].Rtt)
+		{
+			BestIndex = Index;
+		}
+	}
+	ClockOffset = OffsetSamples[BestIndex].Offset;
+
+	// With the offset known the two directions can be told apart, which a plain RTT can't do
+	const float OutboundSample = FMath::Max<int64>(RemoteReceiveTime - LocalSendTime - ClockOffset, 0) / 1000000.0f;
+	const float InboundSample = FMath::Max<int64>(LocalReceiveTime - RemoteSendTime + ClockOffset, 0) / 1000000.0f;
+
+	if (NumSamples == 1)
+	{
+		OutboundDelay = OutboundSample;
+		InboundDelay = InboundSample;
+	}
+	else
+	{
+		OutboundDelay += (OutboundSample - OutboundDelay) * RttGain;
+		InboundDelay += (InboundSample - InboundDelay) * RttGain;
+	}
+}
+
+void FFGRttEstimator::Reset()
+{
+	*this = FFGRttEstimator();
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Round trip time, jitter and clock offset estimate for one connection, fed with NTP style timestamp exchanges.
+// Each sample is the local send time, the remote receive and send times, and the local receive time of one echo, in microseconds.
+struct FG_NET_API FFGRttEstimator
+{
+	void AddSample(int64 LocalSendTime, int64 RemoteReceiveTime, int64 RemoteSendTime, int64 LocalReceiveTime);
+	void Reset();
+
+	bool HasSamples() const { return NumSamples > 0; }
+	int32 GetNumSamples() const { return NumSamples; }
+
+	// Seconds
+	float GetSmoothedRtt() const { return SmoothedRtt; }
+	float GetRttVariance() const { return RttVariance; }
+	float GetLastRtt() const { return LastRtt; }
+	float GetJitter() const { return Jitter; }
+	float GetOutboundDelay() const { return OutboundDelay; }
+	float GetInboundDelay() const { return InboundDelay; }
+
+	// Remote clock minus local clock in microseconds, taken from the lowest delay sample of the last few since those are the least skewed by queuing
+	int64 GetClockOffset() const { return ClockOffset; }
+
+private:
+	static constexpr int32 NumOffsetSamples = 8;
+
+	struct FOffsetSample
+	{
+		int64 Rtt = 0;
+		int64 Offset = 0;
+	};
+
+	FOffsetSample OffsetSamples[NumOffsetSamples];
+	int32 NumSamples = 0;
+	float SmoothedRtt = 0.0f;
+	float RttVariance = 0.0f;
+	float LastRtt = 0.0f;
+	float Jitter = 0.0f;
+	int64 ClockOffset = 0;
+	float OutboundDelay = 0.0f;
+	float InboundDelay = 0.0f;
+};
@@ -0,0 +1,488 @@
+#include "FGSnapshotSubsystem.h"
+#include "Algo/BinarySearch.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "Serialization/BitReader.h"
+#include "Serialization/BitWriter.h"
+#include "FGNetClock.h"
+#include "../Player/FGPlayer.h"
+#include "../Debug/FGNetStats.h"
+
+// A full snapshot of a few hundred players is well below this, anything larger is a malformed payload
+static const uint32 MaxPayloadBits = 64 * 1024 * 8;
+// Forward and turn are in [-1, 1]
+static const float InputScale = 127.0f;
+
+namespace
+{
+	uint32 ZigZagEncode(int32 Value)
+	{
+		return (static_cast<uint32>(Value) << 1) ^ static_cast<uint32>(Value >> 31);
+	}
+
+	int32 ZigZagDecode(uint32 Value)
+	{
+		return static_cast<int32>(Value >> 1) ^ -static_cast<int32>(Value & 1);
+	}
+}
+
+bool FFGSnapshotPayload::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	uint32 PackedNumBits = NumBits;
+	Ar.SerializeIntPacked(PackedNumBits);
+
+	if (Ar.IsLoading())
+	{
+		if (PackedNumBits > MaxPayloadBits)
+		{
+			Ar.SetError();
+			bOutSuccess = false;
+			return false;
+		}
+
+		NumBits = PackedNumBits;
+		Data.SetNumZeroed((NumBits + 7) >> 3);
+	}
+
+	Ar.SerializeBits(Data.GetData(), NumBits);
+	bOutSuccess = !Ar.IsError();
+	return true;
+}
+
+UFGSnapshotSubsystem* UFGSnapshotSubsystem::Get(const UObject* WorldContextObject)
+{
+	UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull);
+	return World != nullptr ? World->GetSubsystem<UFGSnapshotSubsystem>() : nullptr;
+}
+
+void UFGSnapshotSubsystem::RecordMovement(const AFGPlayer& Player, const FVector& Location, uint32 TimeStamp, float Velocity, float Forward, float Turn, uint8 Yaw, bool bBrake)
+{
+	const TWeakObjectPtr<const AFGPlayer> PlayerKey(&Player);
+	FPlayerState* State = LatestStates.Find(PlayerKey);
+
+	if (State == nullptr)
+	{
+		State = &LatestStates.Add(PlayerKey);
+	}
+	else if (UFGNetClockSubsystem::GetDeltaSeconds(TimeStamp, State->TimeStamp) < 0.0f)
+	{
+		return;
+	}
+
+	State->TimeStamp = TimeStamp;
+	State->Location = FIntVector(FMath::RoundToInt(Location.X), FMath::RoundToInt(Location.Y), FMath::RoundToInt(Location.Z));
+	State->Velocity = static_cast<int16>(FMath::Clamp(FMath::RoundToInt(Velocity), static_cast<int32>(MIN_int16), static_cast<int32>(MAX_int16)));
+	State->Forward = static_cast<int8>(FMath::RoundToInt(FMath::Clamp(Forward, -1.0f, 1.0f) * InputScale));
+	State->Turn = static_cast<int8>(FMath::RoundToInt(FMath::Clamp(Turn, -1.0f, 1.0f) * InputScale));
+	State->Yaw = Yaw;
+	State->bBrake = bBrake;
+}
+
+void UFGSnapshotSubsystem::AcknowledgeSnapshot(const AFGPlayer& Viewer, uint16 SnapshotId)
+{
+	FConnection* Connection = Connections.Find(TWeakObjectPtr<const AFGPlayer>(&Viewer));
+
+	if (Connection == nullptr || Connection->History[SnapshotId % HistorySize].Id != SnapshotId)
+	{
+		return;
+	}
+
+	// Acks are unreliable too, so an old one can arrive after a newer one
+	if (Connection->AckedSnapshotId == INDEX_NONE || static_cast<int16>(SnapshotId - static_cast<uint16>(Connection->AckedSnapshotId)) > 0)
+	{
+		Connection->AckedSnapshotId = SnapshotId;
+	}
+}
+
+bool UFGSnapshotSubsystem::IsTickable() const
+{
+	return bEnabled && LatestStates.Num() > 0 && GetWorld()->IsServer();
+}
+
+ETickableTickType UFGSnapshotSubsystem::GetTickableTickType() const
+{
+	return HasAnyFlags(RF_ClassDefaultObject) ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+TStatId UFGSnapshotSubsystem::GetStatId() const
+{
+	return GET_STATID(STAT_FGSnapshots);
+}
+
+void UFGSnapshotSubsystem::Tick(float DeltaTime)
+{
+	CSV_SCOPED_TIMING_STAT(FGNet, Snapshots);
+
+	TimeUntilSnapshot -= DeltaTime;
+
+	if (TimeUntilSnapshot > 0.0f)
+	{
+		return;
+	}
+
+	// Carry the remainder over so the rate holds, but don't burst after a hitch
+	TimeUntilSnapshot = FMath::Max(TimeUntilSnapshot + 1.0f / FMath::Max(SnapshotRate, 1.0f), 0.0f);
+	SendSnapshots();
+}
+
+void UFGSnapshotSubsystem::SendSnapshots()
+{
+	// Every connection's history shares the same copy of this frame's states
+	TSharedRef<FPlayerStates> Players = MakeShared<FPlayerStates>();
+
+	for (auto It = LatestStates.CreateIterator(); It; ++It)
+	{
+		const AFGPlayer* Player = It.Key().Get();
+
+		if (Player == nullptr)
+		{
+			It.RemoveCurrent();
+			continue;
+		}
+
+		FPlayerState& State = Players->Add_GetRef(It.Value());
+		State.PlayerId = GetPlayerId(*Player);
+	}
+
+	Players->RemoveAllSwap([](const FPlayerState& State) { return State.PlayerId == INDEX_NONE; });
+	Players->Sort([](const FPlayerState& A, const FPlayerState& B) { return A.PlayerId < B.PlayerId; });
+
+	for (auto It = Connections.CreateIterator(); It; ++It)
+	{
+		if (!It.Key().IsValid())
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	for (FConstPlayerControllerIterator Iterator = GetWorld()->GetPlayerControllerIterator(); Iterator; ++Iterator)
+	{
+		const APlayerController* PlayerController = Iterator->Get();
+
+		if (PlayerController == nullptr || PlayerController->IsLocalController())
+		{
+			continue;
+		}
+
+		AFGPlayer* Viewer = Cast<AFGPlayer>(PlayerController->GetPawn());
+
+		if (Viewer == nullptr)
+		{
+			continue;
+		}
+
+		FConnection& Connection = Connections.FindOrAdd(TWeakObjectPtr<const AFGPlayer>(Viewer));
+		const uint16 SnapshotId = Connection.NextSnapshotId++;
+		const FSnapshot* Baseline = nullptr;
+
+		// The acknowledged snapshot is gone once the connection has gone a whole history without acknowledging anything
+		if (Connection.AckedSnapshotId != INDEX_NONE)
+		{
+			const FSnapshot& Acked = Connection.History[Connection.AckedSnapshotId % HistorySize];
+
+			if (Acked.Id == Connection.AckedSnapshotId && static_cast<uint16>(SnapshotId - Acked.Id) < HistorySize)
+			{
+				Baseline = &Acked;
+			}
+		}
+
+		if (Baseline == nullptr)
+		{
+			INC_DWORD_STAT(STAT_FGFullSnapshots);
+		}
+
+		FBitWriter Writer(0, true);
+		EncodeSnapshot(Writer, SnapshotId, Baseline, *Players, GetPlayerId(*Viewer));
+
+		FSnapshot& Sent = Connection.History[SnapshotId % HistorySize];
+		Sent.Id = SnapshotId;
+		Sent.Players = Players;
+
+		FFGSnapshotPayload Payload;
+		Payload.NumBits = Writer.GetNumBits();
+		Payload.Data.Append(Writer.GetData(), Writer.GetNumBytes());
+		FFGScopedRPCStat RPCStat(EFGNetRPCType::Movement, *Viewer);
+		Viewer->Client_ReceiveSnapshot(Payload);
+	}
+}
+
+void UFGSnapshotSubsystem::EncodeSnapshot(FArchive& Ar, uint16 SnapshotId, const FSnapshot* Baseline, const FPlayerStates& Players, int32 ExcludedPlayerId)
+{
+	TArray<TPair<FPlayerState, const FPlayerState*>, TInlineAllocator<64>> ChangedPlayers;
+
+	for (const FPlayerState& State : Players)
+	{
+		if (State.PlayerId == ExcludedPlayerId)
+		{
+			continue;
+		}
+
+		const int32 BaselineIndex = Baseline != nullptr ? FindPlayerIndex(*Baseline->Players, State.PlayerId) : INDEX_NONE;
+		const FPlayerState* BaselineState = BaselineIndex != INDEX_NONE ? &(*Baseline->Players)[BaselineIndex] : nullptr;
+
+		if (GetChangedFields(State, BaselineState) != 0)
+		{
+			ChangedPlayers.Emplace(State, BaselineState);
+		}
+	}
+
+	// Players in the baseline that have left, the client would otherwise carry them forward from it
+	TArray<int32, TInlineAllocator<16>> RemovedPlayerIds;
+
+	if (Baseline != nullptr)
+	{
+		for (const FPlayerState& BaselineState : *Baseline->Players)
+		{
+			if (BaselineState.PlayerId != ExcludedPlayerId && FindPlayerIndex(Players, BaselineState.PlayerId) == INDEX_NONE)
+			{
+				RemovedPlayerIds.Add(BaselineState.PlayerId);
+			}
+		}
+	}
+
+	Ar << SnapshotId;
+
+	uint8 bHasBaseline = Baseline != nullptr ? 1 : 0;
+	Ar.SerializeBits(&bHasBaseline, 1);
+
+	if (Baseline != nullptr)
+	{
+		uint16 BaselineId = static_cast<uint16>(Baseline->Id);
+		Ar << BaselineId;
+
+		uint32 NumRemoved = RemovedPlayerIds.Num();
+		Ar.SerializeIntPacked(NumRemoved);
+
+		for (int32 RemovedPlayerId : RemovedPlayerIds)
+		{
+			uint32 PlayerId = RemovedPlayerId;
+			Ar.SerializeIntPacked(PlayerId);
+		}
+	}
+
+	uint32 NumChanged = ChangedPlayers.Num();
+	Ar.SerializeIntPacked(NumChanged);
+
+	for (TPair<FPlayerState, const FPlayerState*>& Changed : ChangedPlayers)
+	{
+		uint32 PlayerId = Changed.Key.PlayerId;
+		Ar.SerializeIntPacked(PlayerId);
+		SerializePlayer(Ar, Changed.Key, Changed.Value);
+	}
+}
+
+void UFGSnapshotSubsystem::ReceiveSnapshot(AFGPlayer& Viewer, const FFGSnapshotPayload& Payload)
+{
+	SCOPE_CYCLE_COUNTER(STAT_FGSnapshots);
+
+	FBitReader Reader(const_cast<uint8*>(Payload.Data.GetData()), Payload.NumBits);
+
+	uint16 SnapshotId = 0;
+	Reader << SnapshotId;
+
+	uint8 bHasBaseline = 0;
+	Reader.SerializeBits(&bHasBaseline, 1);
+
+	const FSnapshot* Baseline = nullptr;
+
+	if (bHasBaseline != 0)
+	{
+		uint16 BaselineId = 0;
+		Reader << BaselineId;
+
+		// Without the baseline nothing can be decoded. Not acknowledging makes the server fall back to an older baseline or a full snapshot.
+		const FSnapshot& Slot = ReceivedHistory[BaselineId % HistorySize];
+		if (Slot.Id != BaselineId || !Slot.Players.IsValid())
+		{
+			return;
+		}
+
+		Baseline = &Slot;
+	}
+
+	TSharedRef<FPlayerStates> Players = Baseline != nullptr ? MakeShared<FPlayerStates>(*Baseline->Players) : MakeShared<FPlayerStates>();
+	TSet<int32, DefaultKeyFuncs<int32>, TInlineSetAllocator<64>> ChangedPlayerIds;
+
+	if (Baseline != nullptr)
+	{
+		uint32 NumRemoved = 0;
+		Reader.SerializeIntPacked(NumRemoved);
+
+		for (uint32 Index = 0; Index < NumRemoved && !Reader.IsError(); ++Index)
+		{
+			uint32 PlayerId = 0;
+			Reader.SerializeIntPacked(PlayerId);
+
+			const int32 PlayerIndex = FindPlayerIndex(*Players, PlayerId);
+			if (PlayerIndex != INDEX_NONE)
+			{
+				Players->RemoveAt(PlayerIndex);
+			}
+		}
+	}
+
+	uint32 NumChanged = 0;
+	Reader.SerializeIntPacked(NumChanged);
+
+	for (uint32 Index = 0; Index < NumChanged && !Reader.IsError(); ++Index)
+	{
+		uint32 PlayerId = 0;
+		Reader.SerializeIntPacked(PlayerId);
+
+		int32 PlayerIndex = FindPlayerIndex(*Players, PlayerId);
+
+		if (PlayerIndex == INDEX_NONE)
+		{
+			PlayerIndex = Algo::LowerBoundBy(*Players, static_cast<int32>(PlayerId), &FPlayerState::PlayerId);
+			Players->Insert(FPlayerState(), PlayerIndex);
+			(*Players)[PlayerIndex].PlayerId = PlayerId;
+			SerializePlayer(Reader, (*Players)[PlayerIndex], nullptr);
+		}
+		else
+		{
+			const FPlayerState BaselineState = (*Players)[PlayerIndex];
+			SerializePlayer(Reader, (*Players)[PlayerIndex], &BaselineState);
+		}
+
+		ChangedPlayerIds.Add(PlayerId);
+	}
+
+	if (Reader.IsError())
+	{
+		return;
+	}
+
+	FSnapshot& Received = ReceivedHistory[SnapshotId % HistorySize];
+	Received.Id = SnapshotId;
+	Received.Players = Players;
+
+	Viewer.Server_AckSnapshot(SnapshotId);
+
+	bool bCanRefresh = true;
+	for (const FPlayerState& State : *Players)
+	{
+		AFGPlayer* Player = FindPlayerById(State.PlayerId, bCanRefresh);
+
+		// Players that became relevant after their last change still need the state once
+		if (Player == nullptr || (!ChangedPlayerIds.Contains(State.PlayerId) && Player->bHasRemoteTimeStamp))
+		{
+			continue;
+		}
+
+		Player->ApplyRemoteMovement(FVector(State.Location), State.TimeStamp, State.Velocity, State.Forward / InputScale, State.Turn / InputScale, State.Yaw, State.bBrake);
+	}
+}
+
+void UFGSnapshotSubsystem::SerializePlayer(FArchive& Ar, FPlayerState& State, const FPlayerState* Baseline)
+{
+	uint8 Fields = Ar.IsSaving() ? GetChangedFields(State, Baseline) : 0;
+	Ar.SerializeBits(&Fields, NumFieldBits);
+
+	if (Fields & Field_TimeStamp)
+	{
+		if (Baseline != nullptr)
+		{
+			uint32 Delta = ZigZagEncode(static_cast<int32>(State.TimeStamp - Baseline->TimeStamp));
+			Ar.SerializeIntPacked(Delta);
+			State.TimeStamp = Baseline->TimeStamp + static_cast<uint32>(ZigZagDecode(Delta));
+		}
+		else
+		{
+			Ar << State.TimeStamp;
+		}
+	}
+
+	if (Fields & Field_Location)
+	{
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+		{
+			const int32 BaselineValue = Baseline != nullptr ? Baseline->Location[Axis] : 0;
+			uint32 Delta = ZigZagEncode(State.Location[Axis] - BaselineValue);
+			Ar.SerializeIntPacked(Delta);
+			State.Location[Axis] = BaselineValue + ZigZagDecode(Delta);
+		}
+	}
+
+	if (Fields & Field_Velocity)
+	{
+		Ar << State.Velocity;
+	}
+
+	if (Fields & Field_Yaw)
+	{
+		Ar << State.Yaw;
+	}
+
+	if (Fields & Field_Input)
+	{
+		Ar << State.Forward;
+		Ar << State.Turn;
+
+		uint8 bBrake = State.bBrake ? 1 : 0;
+		Ar.SerializeBits(&bBrake, 1);
+		State.bBrake = bBrake != 0;
+	}
+}
+
+uint8 UFGSnapshotSubsystem::GetChangedFields(const FPlayerState& State, const FPlayerState* Baseline)
+{
+	if (Baseline == nullptr)
+	{
+		return Field_TimeStamp | Field_Location | Field_Velocity | Field_Yaw | Field_Input;
+	}
+
+	uint8 Fields = 0;
+	Fields |= State.TimeStamp != Baseline->TimeStamp ? Field_TimeStamp : 0;
+	Fields |= State.Location != Baseline->Location ? Field_Location : 0;
+	Fields |= State.Velocity != Baseline->Velocity ? Field_Velocity : 0;
+	Fields |= State.Yaw != Baseline->Yaw ? Field_Yaw : 0;
+	Fields |= (State.Forward != Baseline->Forward || State.Turn != Baseline->Turn || State.bBrake != Baseline->bBrake) ? Field_Input : 0;
+	return Fields;
+}
+
+int32 UFGSnapshotSubsystem::FindPlayerIndex(const FPlayerStates& Players, int32 PlayerId)
+{
+	return Algo::BinarySearchBy(Players, PlayerId, &FPlayerState::PlayerId);
+}
+
+int32 UFGSnapshotSubsystem::GetPlayerId(const AFGPlayer& Player)
+{
+	const APlayerState* PlayerState = Player.GetPlayerState();
+	return PlayerState != nullptr ? PlayerState->GetPlayerId() : INDEX_NONE;
+}
+
+AFGPlayer* UFGSnapshotSubsystem::FindPlayerById(int32 PlayerId, bool& bCanRefresh)
+{
+	if (const TWeakObjectPtr<AFGPlayer>* Found = PlayersById.Find(PlayerId))
+	{
+		if (Found->IsValid())
+		{
+			return Found->Get();
+		}
+	}
+
+	if (!bCanRefresh)
+	{
+		return nullptr;
+	}
+
+	// Player states replicate some time after the pawns, so keep looking for players that aren't known yet
+	bCanRefresh = false;
+	PlayersById.Reset();
+
+	for (TActorIterator<AFGPlayer> It(GetWorld()); It; ++It)
+	{
+		const int32 Id = GetPlayerId(**It);
+
+		if (Id != INDEX_NONE)
+		{
+			PlayersById.Add(Id, *It);
+		}
+	}
+
+	const TWeakObjectPtr<AFGPlayer>* Found = PlayersById.Find(PlayerId);
+	return Found != nullptr ? Found->Get() : nullptr;
+}
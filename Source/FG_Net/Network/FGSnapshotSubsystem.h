@@ -0,0 +1,126 @@
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "FGSnapshotSubsystem.generated.h"
+
+class AFGPlayer;
+
+// Pre-encoded snapshot bits, written to the bunch as is so there is no byte padding or array overhead
+USTRUCT()
+struct FG_NET_API FFGSnapshotPayload
+{
+	GENERATED_BODY()
+
+	TArray<uint8> Data;
+	int32 NumBits = 0;
+
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FFGSnapshotPayload> : public TStructOpsTypeTraitsBase2<FFGSnapshotPayload>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
+
+// Optional replacement for forwarding every movement update to every client.
+// The server keeps the latest movement each player sent and, at a fixed rate, sends each connection one unreliable snapshot of all
+// other players. Snapshots are delta encoded against the last one that connection acknowledged and players whose state didn't
+// change are left out, while players that have left since are listed as removed. When nothing acknowledged is still in the
+// history the snapshot is sent in full.
+UCLASS(Config = Engine)
+class FG_NET_API UFGSnapshotSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+public:
+	static UFGSnapshotSubsystem* Get(const UObject* WorldContextObject);
+
+	bool IsEnabled() const { return bEnabled; }
+
+	// Server side, takes the place of forwarding the update to the other clients. The parameters are those of Server_SendMovement.
+	void RecordMovement(const AFGPlayer& Player, const FVector& Location, uint32 TimeStamp, float Velocity, float Forward, float Turn, uint8 Yaw, bool bBrake);
+	void AcknowledgeSnapshot(const AFGPlayer& Viewer, uint16 SnapshotId);
+
+	// Client side, applies the changed players and acknowledges the snapshot through Viewer
+	void ReceiveSnapshot(AFGPlayer& Viewer, const FFGSnapshotPayload& Payload);
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+
+	UPROPERTY(Config)
+	bool bEnabled = false;
+
+	// Snapshots per second sent to each connection
+	UPROPERTY(Config)
+	float SnapshotRate = 20.0f;
+
+private:
+	static constexpr int32 HistorySize = 32;
+
+	// Quantized the way it goes on the wire, so comparing against a baseline compares what the client has
+	struct FPlayerState
+	{
+		int32 PlayerId = INDEX_NONE;
+		uint32 TimeStamp = 0;
+		FIntVector Location = FIntVector::ZeroValue;
+		int16 Velocity = 0;
+		int8 Forward = 0;
+		int8 Turn = 0;
+		uint8 Yaw = 0;
+		bool bBrake = false;
+	};
+
+	// Sorted by PlayerId so a snapshot and its baseline can be walked together
+	using FPlayerStates = TArray<FPlayerState>;
+
+	struct FSnapshot
+	{
+		int32 Id = INDEX_NONE;
+		TSharedPtr<const FPlayerStates> Players;
+	};
+
+	struct FConnection
+	{
+		FSnapshot History[HistorySize];
+		uint16 NextSnapshotId = 0;
+		int32 AckedSnapshotId = INDEX_NONE;
+	};
+
+	enum EField : uint8
+	{
+		Field_TimeStamp = 1 << 0,
+		Field_Location = 1 << 1,
+		Field_Velocity = 1 << 2,
+		Field_Yaw = 1 << 3,
+		Field_Input = 1 << 4,
+		NumFieldBits = 5
+	};
+
+	static void EncodeSnapshot(FArchive& Ar, uint16 SnapshotId, const FSnapshot* Baseline, const FPlayerStates& Players, int32 ExcludedPlayerId);
+	// Writes or reads the fields that differ from Baseline, all of them without one. When loading State starts out as Baseline.
+	static void SerializePlayer(FArchive& Ar, FPlayerState& State, const FPlayerState* Baseline);
+	static uint8 GetChangedFields(const FPlayerState& State, const FPlayerState* Baseline);
+	static int32 FindPlayerIndex(const FPlayerStates& Players, int32 PlayerId);
+	static int32 GetPlayerId(const AFGPlayer& Player);
+
+	// Rebuilds the lookup on a miss while bCanRefresh is set, then clears it so that happens once per snapshot
+	AFGPlayer* FindPlayerById(int32 PlayerId, bool& bCanRefresh);
+
+	void SendSnapshots();
+
+	// Server, latest update each player sent
+	TMap<TWeakObjectPtr<const AFGPlayer>, FPlayerState> LatestStates;
+	TMap<TWeakObjectPtr<const AFGPlayer>, FConnection> Connections;
+	float TimeUntilSnapshot = 0.0f;
+
+	// Client, snapshots rebuilt from the ones received
+	FSnapshot ReceivedHistory[HistorySize];
+	TMap<int32, TWeakObjectPtr<AFGPlayer>> PlayersById;
+};
@@ -0,0 +1,99 @@
+#include "FGTickRateGovernor.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "HAL/PlatformTime.h"
+#include "FGReplicationGraph.h"
+#include "../Debug/FGNetStats.h"
+
+bool UFGTickRateGovernor::IsTickable() const
+{
+	const UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+	return bEnabled && NetDriver != nullptr && NetDriver->IsServer();
+}
+
+ETickableTickType UFGTickRateGovernor::GetTickableTickType() const
+{
+	return HasAnyFlags(RF_ClassDefaultObject) ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+TStatId UFGTickRateGovernor::GetStatId() const
+{
+	return GET_STATID(STAT_FGTickRateGovernor);
+}
+
+void UFGTickRateGovernor::Tick(float DeltaTime)
+{
+	if (CurrentTickRate == 0)
+	{
+		// The configured rate is what the replication periods were set up for, so replication is only scaled down below it
+		BaseTickRate = FMath::Max(GetWorld()->GetNetDriver()->NetServerMaxTickRate, 1);
+		SetTickRate(FMath::Clamp(BaseTickRate, MinTickRate, GetTickRateCeiling()));
+	}
+
+	GameThreadMsSum += FPlatformTime::ToMilliseconds(GGameThreadTime);
+	++NumFrames;
+	TimeSinceEvaluation += DeltaTime;
+	TimeSinceChange += DeltaTime;
+
+	CSV_CUSTOM_STAT(FGNet, ServerTickRate, CurrentTickRate, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(FGNet, ServerFrameLoad, Load, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(FGNet, NetUpdateFrequencyScale, NetUpdateFrequencyScale, ECsvCustomStatOp::Set);
+
+	if (TimeSinceEvaluation < EvaluationInterval)
+	{
+		return;
+	}
+
+	// Share of the frame time at the current rate that the game thread actually used
+	Load = GameThreadMsSum / NumFrames * CurrentTickRate / 1000.0f;
+	GameThreadMsSum = 0.0f;
+	NumFrames = 0;
+	TimeSinceEvaluation = 0.0f;
+
+	int32 NewTickRate = CurrentTickRate;
+
+	if (Load > HighLoad)
+	{
+		NewTickRate -= TickRateStep;
+	}
+	else if (Load < LowLoad && TimeSinceChange >= RaiseCooldown)
+	{
+		NewTickRate += TickRateStep;
+	}
+
+	// Also brings the rate down straight away when players join
+	NewTickRate = FMath::Clamp(NewTickRate, MinTickRate, GetTickRateCeiling());
+
+	if (NewTickRate != CurrentTickRate)
+	{
+		SetTickRate(NewTickRate);
+	}
+
+	SET_FLOAT_STAT(STAT_FGServerFrameLoad, Load);
+}
+
+int32 UFGTickRateGovernor::GetTickRateCeiling() const
+{
+	const float LobbyAlpha = FullLobbyPlayers > 0 ? FMath::Clamp(static_cast<float>(GetWorld()->GetNumPlayerControllers()) / FullLobbyPlayers, 0.0f, 1.0f) : 0.0f;
+	const int32 Ceiling = FMath::RoundToInt(FMath::Lerp(static_cast<float>(MaxTickRate), static_cast<float>(FullLobbyTickRate), LobbyAlpha));
+	return FMath::Max(Ceiling, MinTickRate);
+}
+
+void UFGTickRateGovernor::SetTickRate(int32 NewTickRate)
+{
+	CurrentTickRate = NewTickRate;
+	TimeSinceChange = 0.0f;
+	NetUpdateFrequencyScale = FMath::Clamp(static_cast<float>(NewTickRate) / BaseTickRate, MinNetUpdateFrequencyScale, 1.0f);
+
+	UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+	NetDriver->NetServerMaxTickRate = NewTickRate;
+
+	if (UFGReplicationGraph* ReplicationGraph = Cast<UFGReplicationGraph>(NetDriver->GetReplicationDriver()))
+	{
+		ReplicationGraph->SetReplicationRates(NewTickRate, NetUpdateFrequencyScale);
+	}
+
+	SET_DWORD_STAT(STAT_FGServerTickRate, CurrentTickRate);
+	SET_FLOAT_STAT(STAT_FGNetUpdateFrequencyScale, NetUpdateFrequencyScale);
+	CSV_EVENT(FGNet, TEXT("ServerTickRate %d"), CurrentTickRate);
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "FGTickRateGovernor.generated.h"
+
+// Lowers the server tick rate and replication rate when the game thread runs out of frame budget and raises them again once there
+// is headroom. The ceiling also comes down as the lobby fills up, so a full server settles at a lower rate before it starts hitching.
+// Runs on the server only. The tick rate is NetServerMaxTickRate, which listen servers only follow with bClampListenServerTickRate.
+UCLASS(Config = Engine)
+class FG_NET_API UFGTickRateGovernor : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+public:
+	int32 GetTickRate() const { return CurrentTickRate; }
+	float GetNetUpdateFrequencyScale() const { return NetUpdateFrequencyScale; }
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+
+	UPROPERTY(Config)
+	bool bEnabled = true;
+
+	UPROPERTY(Config)
+	int32 MinTickRate = 20;
+
+	UPROPERTY(Config)
+	int32 MaxTickRate = 60;
+
+	// Ceiling once FullLobbyPlayers are connected, scaled linearly from MaxTickRate with fewer
+	UPROPERTY(Config)
+	int32 FullLobbyTickRate = 30;
+
+	UPROPERTY(Config)
+	int32 FullLobbyPlayers = 64;
+
+	UPROPERTY(Config)
+	int32 TickRateStep = 5;
+
+	// Lowest scale applied to every class's NetUpdateFrequency, reached at MinTickRate
+	UPROPERTY(Config)
+	float MinNetUpdateFrequencyScale = 0.5f;
+
+	// Share of the frame at the current tick rate the game thread may use before the rate goes down
+	UPROPERTY(Config)
+	float HighLoad = 0.85f;
+
+	// Below this share the rate goes back up
+	UPROPERTY(Config)
+	float LowLoad = 0.5f;
+
+	// Seconds of game thread time averaged for each decision
+	UPROPERTY(Config)
+	float EvaluationInterval = 1.0f;
+
+	// Seconds to wait after a change before raising the rate again, so it doesn't oscillate around the budget
+	UPROPERTY(Config)
+	float RaiseCooldown = 5.0f;
+
+private:
+	int32 GetTickRateCeiling() const;
+	void SetTickRate(int32 NewTickRate);
+
+	int32 BaseTickRate = 0;
+	int32 CurrentTickRate = 0;
+	float NetUpdateFrequencyScale = 1.0f;
+	float GameThreadMsSum = 0.0f;
+	int32 NumFrames = 0;
+	float TimeSinceEvaluation = 0.0f;
+	float TimeSinceChange = 0.0f;
+	float Load = 0.0f;
+};
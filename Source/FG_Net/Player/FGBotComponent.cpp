@@ -0,0 +1,140 @@
+#include "FGBotComponent.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "HAL/PlatformProcess.h"
+#include "FGPlayer.h"
+
+UFGBotComponent::UFGBotComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.TickGroup = TG_PrePhysics;
+}
+
+bool UFGBotComponent::IsBotRequested()
+{
+	return FParse::Param(FCommandLine::Get(), TEXT("FGBot"));
+}
+
+void UFGBotComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	int32 Seed = 0;
+	if (!FParse::Value(FCommandLine::Get(), TEXT("FGBotSeed="), Seed))
+	{
+		Seed = static_cast<int32>(FPlatformProcess::GetCurrentProcessId());
+	}
+
+	RandomStream.Initialize(Seed);
+
+	FString ScriptPath;
+	if (FParse::Value(FCommandLine::Get(), TEXT("FGBotScript="), ScriptPath) && !LoadScript(ScriptPath))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("FGBot: Could not load script %s, falling back to random input"), *ScriptPath);
+	}
+
+	NextCommand();
+}
+
+void UFGBotComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	AFGPlayer* Player = Cast<AFGPlayer>(GetOwner());
+
+	if (Player == nullptr || !Player->IsLocallyControlled())
+	{
+		return;
+	}
+
+	CommandTimeRemaining -= DeltaTime;
+
+	if (CommandTimeRemaining <= 0.0f)
+	{
+		NextCommand();
+	}
+
+	ApplyCommand(*Player);
+}
+
+bool UFGBotComponent::LoadScript(const FString& ScriptPath)
+{
+	TArray<FString> Lines;
+
+	if (!FFileHelper::LoadFileToStringArray(Lines, *ScriptPath))
+	{
+		return false;
+	}
+
+	// Each line is "Duration Accelerate Turn Brake Fire", lines starting with # are ignored
+	for (const FString& Line : Lines)
+	{
+		if (Line.IsEmpty() || Line.StartsWith(TEXT("#")))
+		{
+			continue;
+		}
+
+		TArray<FString> Values;
+		Line.ParseIntoArrayWS(Values);
+
+		if (Values.Num() < 5)
+		{
+			continue;
+		}
+
+		FBotCommand& Command = Script.AddDefaulted_GetRef();
+		Command.Duration = FMath::Max(FCString::Atof(*Values[0]), 0.01f);
+		Command.Accelerate = FMath::Clamp(FCString::Atof(*Values[1]), -1.0f, 1.0f);
+		Command.Turn = FMath::Clamp(FCString::Atof(*Values[2]), -1.0f, 1.0f);
+		Command.bBrake = FCString::Atoi(*Values[3]) != 0;
+		Command.bFire = FCString::Atoi(*Values[4]) != 0;
+	}
+
+	return Script.Num() > 0;
+}
+
+void UFGBotComponent::NextCommand()
+{
+	if (Script.Num() > 0)
+	{
+		CurrentCommand = Script[ScriptIndex];
+		ScriptIndex = (ScriptIndex + 1) % Script.Num();
+	}
+	else
+	{
+		CurrentCommand.Duration = RandomStream.FRandRange(0.5f, 3.0f);
+		CurrentCommand.Accelerate = RandomStream.FRandRange(-0.25f, 1.0f);
+		CurrentCommand.Turn = RandomStream.FRandRange(-1.0f, 1.0f);
+		CurrentCommand.bBrake = RandomStream.FRand() < 0.1f;
+		CurrentCommand.bFire = RandomStream.FRand() < 0.3f;
+	}
+
+	CommandTimeRemaining += CurrentCommand.Duration;
+	CommandTimeRemaining = FMath::Max(CommandTimeRemaining, 0.0f);
+}
+
+void UFGBotComponent::ApplyCommand(AFGPlayer& Player)
+{
+	Player.Handle_Accelerate(CurrentCommand.Accelerate);
+	Player.Handle_Turn(CurrentCommand.Turn);
+
+	if (CurrentCommand.bBrake != bIsBraking)
+	{
+		bIsBraking = CurrentCommand.bBrake;
+
+		if (bIsBraking)
+		{
+			Player.Handle_BrakePressed();
+		}
+		else
+		{
+			Player.Handle_BrakeReleased();
+		}
+	}
+
+	if (CurrentCommand.bFire)
+	{
+		Player.FireRocket();
+	}
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Components/ActorComponent.h"
+#include "FGBotComponent.generated.h"
+
+class AFGPlayer;
+
+// Drives a locally controlled player from a seeded random or scripted input pattern. Added when running with -FGBot.
+UCLASS()
+class FG_NET_API UFGBotComponent : public UActorComponent
+{
+	GENERATED_BODY()
+public:
+	UFGBotComponent();
+
+	static bool IsBotRequested();
+
+	virtual void BeginPlay() override;
+	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+private:
+	struct FBotCommand
+	{
+		float Duration = 1.0f;
+		float Accelerate = 0.0f;
+		float Turn = 0.0f;
+		bool bBrake = false;
+		bool bFire = false;
+	};
+
+	bool LoadScript(const FString& ScriptPath);
+	void NextCommand();
+	void ApplyCommand(AFGPlayer& Player);
+
+	TArray<FBotCommand> Script;
+	FBotCommand CurrentCommand;
+	FRandomStream RandomStream;
+	int32 ScriptIndex = 0;
+	float CommandTimeRemaining = 0.0f;
+	bool bIsBraking = false;
+};
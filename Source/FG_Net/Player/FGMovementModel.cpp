@@ -0,0 +1,30 @@
+#include "FGMovementModel.h"
+#include "FGPlayerSettings.h"
+
+float FFGMovementModel::StepYaw(float Yaw, float Velocity, const FFGMovementInput& Input, const UFGPlayerSettings& Settings, float DeltaTime)
+{
+	const float Alpha = FMath::Clamp(FMath::Abs(Velocity / (Settings.MaxVelocity * 0.75f)), 0.0f, 1.0f);
+	const float TurnSpeed = FMath::InterpEaseOut(0.0f, Settings.TurnSpeedDefault, Alpha, 5.0f);
+	const float MovementDirection = Velocity > 0.0f ? Input.Turn : -Input.Turn;
+
+	return Yaw + (MovementDirection * TurnSpeed) * DeltaTime;
+}
+
+float FFGMovementModel::StepVelocity(float Velocity, const FFGMovementInput& Input, const UFGPlayerSettings& Settings, float DeltaTime)
+{
+	const float Friction = Input.bBrake ? Settings.BreakingFriction : Settings.DefaultFriction;
+
+	Velocity += Input.Forward * Settings.Acceleration * DeltaTime;
+	Velocity = FMath::Clamp(Velocity, -Settings.MaxVelocity, Settings.MaxVelocity);
+	return Velocity * FMath::Pow(Friction, DeltaTime);
+}
+
+void FFGMovementModel::Step(FFGMovementModelState& State, const FFGMovementInput& Input, const UFGPlayerSettings& Settings, float DeltaTime)
+{
+	// The player moves along the facing it had at the start of the step, see AFGPlayer::SimulateStep
+	const FVector Direction = FRotator(0.0f, State.Yaw, 0.0f).Vector();
+
+	State.Yaw = StepYaw(State.Yaw, State.Velocity, Input, Settings, DeltaTime);
+	State.Velocity = StepVelocity(State.Velocity, Input, Settings, DeltaTime);
+	State.Location += Direction * State.Velocity * DeltaTime;
+}
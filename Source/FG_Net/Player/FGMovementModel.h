@@ -0,0 +1,35 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UFGPlayerSettings;
+
+// Inputs that drive a player's movement. Sent with movement updates so receivers can keep simulating between them.
+struct FFGMovementInput
+{
+	float Forward = 0.0f;
+	float Turn = 0.0f;
+	bool bBrake = false;
+
+	bool operator==(const FFGMovementInput& Other) const { return Forward == Other.Forward && Turn == Other.Turn && bBrake == Other.bBrake; }
+	bool operator!=(const FFGMovementInput& Other) const { return !(*this == Other); }
+};
+
+struct FFGMovementModelState
+{
+	FVector Location = FVector::ZeroVector;
+	float Velocity = 0.0f;
+	float Yaw = 0.0f;
+};
+
+// Movement rules shared by the locally controlled simulation, remote players and the dead reckoning send policy.
+// Step ignores collision, the player's own simulation moves through UFGMovementComponent instead.
+struct FG_NET_API FFGMovementModel
+{
+	// Steps simulated in one frame at most, time beyond that is dropped after a hitch
+	static constexpr int32 MaxStepsPerFrame = 8;
+
+	static float StepYaw(float Yaw, float Velocity, const FFGMovementInput& Input, const UFGPlayerSettings& Settings, float DeltaTime);
+	static float StepVelocity(float Velocity, const FFGMovementInput& Input, const UFGPlayerSettings& Settings, float DeltaTime);
+	static void Step(FFGMovementModelState& State, const FFGMovementInput& Input, const UFGPlayerSettings& Settings, float DeltaTime);
+};
@@ -0,0 +1,125 @@
+#include "FGMovementPriorityScheduler.h"
+#include "GameFramework/PlayerController.h"
+#include "FGPlayer.h"
+#include "FGPlayerSettings.h"
+
+// Object reference, location, timestamp, velocity, input and yaw plus RPC header
+static const int32 EstimatedMovementRPCBytes = 41;
+// Share of the budget kept for players that are close or on screen
+static const float HighPriorityBudgetReserve = 0.25f;
+
+bool FFGMovementBandwidthBudget::TryConsume(float CurrentTime, int32 NumBytes, int32 BytesPerSecond, bool bHighPriority)
+{
+	if (CurrentTime - WindowStartTime >= 1.0f)
+	{
+		WindowStartTime = CurrentTime;
+		BytesSent = 0;
+	}
+
+	const float Limit = bHighPriority ? BytesPerSecond : BytesPerSecond * (1.0f - HighPriorityBudgetReserve);
+
+	if (BytesSent + NumBytes > Limit)
+	{
+		return false;
+	}
+
+	BytesSent += NumBytes;
+	return true;
+}
+
+bool FFGMovementPriorityScheduler::ShouldSendTo(const AFGPlayer& Mover, AFGPlayer& Viewer, float CurrentTime, const UFGPlayerSettings& Settings)
+{
+	FViewerState& ViewerState = Viewers.FindOrAdd(TWeakObjectPtr<AFGPlayer>(&Viewer));
+
+	if (TrySend(Mover, Viewer, ViewerState, CurrentTime, Settings))
+	{
+		return true;
+	}
+
+	if (!ViewerState.bPending)
+	{
+		ViewerState.bPending = true;
+		NumPendingViewers++;
+	}
+
+	return false;
+}
+
+void FFGMovementPriorityScheduler::TakeDueViewers(const AFGPlayer& Mover, float CurrentTime, const UFGPlayerSettings& Settings, TArray<AFGPlayer*>& OutViewers)
+{
+	for (auto It = Viewers.CreateIterator(); It; ++It)
+	{
+		AFGPlayer* Viewer = It.Key().Get();
+
+		if (Viewer == nullptr)
+		{
+			NumPendingViewers -= It.Value().bPending ? 1 : 0;
+			It.RemoveCurrent();
+		}
+		else if (It.Value().bPending && TrySend(Mover, *Viewer, It.Value(), CurrentTime, Settings))
+		{
+			OutViewers.Add(Viewer);
+		}
+	}
+}
+
+void FFGMovementPriorityScheduler::RemoveStaleViewers()
+{
+	for (auto It = Viewers.CreateIterator(); It; ++It)
+	{
+		if (!It.Key().IsValid())
+		{
+			NumPendingViewers -= It.Value().bPending ? 1 : 0;
+			It.RemoveCurrent();
+		}
+	}
+}
+
+bool FFGMovementPriorityScheduler::TrySend(const AFGPlayer& Mover, AFGPlayer& Viewer, FViewerState& ViewerState, float CurrentTime, const UFGPlayerSettings& Settings)
+{
+	const float SendInterval = GetSendInterval(Mover, Viewer, Settings);
+
+	if (CurrentTime - ViewerState.LastSendTime < SendInterval)
+	{
+		return false;
+	}
+
+	const bool bHighPriority = SendInterval <= KINDA_SMALL_NUMBER;
+
+	if (!Viewer.GetMovementBandwidthBudget().TryConsume(CurrentTime, EstimatedMovementRPCBytes, Settings.MovementBandwidthBudget, bHighPriority))
+	{
+		return false;
+	}
+
+	ViewerState.LastSendTime = CurrentTime;
+
+	if (ViewerState.bPending)
+	{
+		ViewerState.bPending = false;
+		NumPendingViewers--;
+	}
+
+	return true;
+}
+
+float FFGMovementPriorityScheduler::GetSendInterval(const AFGPlayer& Mover, const AFGPlayer& Viewer, const UFGPlayerSettings& Settings) const
+{
+	FVector ViewLocation = Viewer.GetActorLocation();
+	FRotator ViewRotation = Viewer.GetActorRotation();
+
+	if (const APlayerController* PlayerController = Cast<APlayerController>(Viewer.GetController()))
+	{
+		PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+	}
+
+	const FVector ToMover = Mover.GetActorLocation() - ViewLocation;
+	const float Distance = ToMover.Size();
+	float Alpha = FMath::Clamp(FMath::GetRangePct(Settings.NearUpdateDistance, Settings.FarUpdateDistance, Distance), 0.0f, 1.0f);
+
+	if (Distance > KINDA_SMALL_NUMBER && FVector::DotProduct(ViewRotation.Vector(), ToMover / Distance) >= Settings.OnScreenViewDot)
+	{
+		Alpha *= 0.5f;
+	}
+
+	return Alpha / Settings.MinRemoteUpdateRate;
+}
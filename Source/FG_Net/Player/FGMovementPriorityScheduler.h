@@ -0,0 +1,60 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtr.h"
+
+class AFGPlayer;
+class UFGPlayerSettings;
+
+// Movement bytes sent to one connection within the current one second window
+struct FFGMovementBandwidthBudget
+{
+	bool TryConsume(float CurrentTime, int32 NumBytes, int32 BytesPerSecond, bool bHighPriority);
+
+private:
+	float WindowStartTime = 0.0f;
+	int32 BytesSent = 0;
+};
+
+// Latest movement update received from a player, kept for the viewers it couldn't be forwarded to yet
+struct FFGRelayedMovement
+{
+	FVector Location = FVector::ZeroVector;
+	uint32 TimeStamp = 0;
+	float Velocity = 0.0f;
+	float Forward = 0.0f;
+	float Turn = 0.0f;
+	uint8 Yaw = 0;
+	bool bBrake = false;
+};
+
+// Decides, per viewing connection, how often a player's movement is forwarded to it.
+// Updates carry the full state and are only sent when the prediction drifts, so a refused update is held back rather than dropped.
+// The viewer then gets the latest one once its interval is up.
+class FFGMovementPriorityScheduler
+{
+public:
+	// Returns false if the update is held back for this viewer
+	bool ShouldSendTo(const AFGPlayer& Mover, AFGPlayer& Viewer, float CurrentTime, const UFGPlayerSettings& Settings);
+
+	// Viewers with a held back update whose interval is up, they count as sent to
+	void TakeDueViewers(const AFGPlayer& Mover, float CurrentTime, const UFGPlayerSettings& Settings, TArray<AFGPlayer*>& OutViewers);
+
+	void RemoveStaleViewers();
+
+	int32 GetNumViewers() const { return Viewers.Num(); }
+	bool HasPendingViewers() const { return NumPendingViewers > 0; }
+
+private:
+	struct FViewerState
+	{
+		float LastSendTime = -BIG_NUMBER;
+		bool bPending = false;
+	};
+
+	bool TrySend(const AFGPlayer& Mover, AFGPlayer& Viewer, FViewerState& ViewerState, float CurrentTime, const UFGPlayerSettings& Settings);
+	float GetSendInterval(const AFGPlayer& Mover, const AFGPlayer& Viewer, const UFGPlayerSettings& Settings) const;
+
+	TMap<TWeakObjectPtr<AFGPlayer>, FViewerState> Viewers;
+	int32 NumPendingViewers = 0;
+};
@@ -4,17 +4,32 @@
 #include "Components/SphereComponent.h"
 #include "GameFramework/SpringArmComponent.h"
 #include "GameFramework/PlayerState.h"
+#include "GameFramework/PlayerController.h"
 #include "Camera/CameraComponent.h"
 #include "Engine/NetDriver.h"
 #include "../Components/FGMovementComponent.h"
 #include "../FGMovementStatics.h"
 #include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
 #include "FGPlayerSettings.h"
 #include "../Debug/UI/FGNetDebugWidget.h"
 #include "../FGPickup.h"
 #include "../FGRocket.h"
-
-const static float MaxMoveDeltaTime = 0.125f;
+#include "../Debug/FGNetStats.h"
+#include "../Debug/FGLoadTestRecorder.h"
+#include "../Debug/FGCorrectionTelemetry.h"
+#include "../Debug/FGNetRecorder.h"
+#include "FGBotComponent.h"
+#include "FGProxyMovementSubsystem.h"
+
+const static float MaxRemoteCatchUpTime = 0.25f;
+const static float DefaultSimulationStepTime = 1.0f / 60.0f;
+const static float ServerFrameTimeInterval = 1.0f;
+const static float RttEchoInterval = 0.1f;
+const static float MinSmoothingTime = 0.05f;
+const static float MaxSmoothingTime = 0.5f;
+
+const static int32 MovementYawBits = 8;
 
 #pragma region Constructor & UE Methods
 
@@ -28,12 +43,15 @@ AFGPlayer::AFGPlayer()
 	MeshComponent = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("MeshComponent"));
 	MeshComponent->SetupAttachment(CollisionComponent);
 
+#if !UE_SERVER
+	// The server target never views through a player
 	SpringArmComponent = CreateDefaultSubobject<USpringArmComponent>(TEXT("SpringArmComponent"));
 	SpringArmComponent->bInheritYaw = false;
 	SpringArmComponent->SetupAttachment(CollisionComponent);
 
 	CameraComponent = CreateDefaultSubobject<UCameraComponent>(TEXT("CameraComponent"));
 	CameraComponent->SetupAttachment(SpringArmComponent);
+#endif
 
 	MovementComponent = CreateDefaultSubobject<UFGMovementComponent>(TEXT("MovementComponent"));
 
@@ -44,6 +62,14 @@ void AFGPlayer::BeginPlay()
 {
 	Super::BeginPlay();
 	MovementComponent->SetUpdatedComponent(CollisionComponent);
+	NetClock = UFGNetClockSubsystem::Get(this);
+	ProxyMovement = UFGProxyMovementSubsystem::Get(this);
+	Snapshots = UFGSnapshotSubsystem::Get(this);
+
+	if (ProxyMovement != nullptr)
+	{
+		ProxyMovement->RegisterPlayer(this);
+	}
 
 	CreateDebugWidget();
 	if (DebugMenuInstance != nullptr)
@@ -53,64 +79,138 @@ void AFGPlayer::BeginPlay()
 
 	SpawnRockets();
 
+	if (UFGBotComponent::IsBotRequested())
+	{
+		UFGBotComponent* BotComponent = NewObject<UFGBotComponent>(this, TEXT("BotComponent"));
+		BotComponent->RegisterComponent();
+	}
+
 	BP_OnNumRocketsChanged(NumRockets);
 	BP_OnHealthChanged(Health);
 	OriginalMeshOffset = MeshComponent->GetRelativeLocation();
+	PreviousSimulationLocation = GetActorLocation();
+
+	if (SpringArmComponent != nullptr)
+	{
+		OriginalSpringArmOffset = SpringArmComponent->GetRelativeLocation();
+	}
+
+	// Dedicated servers started from a client or editor build still construct the camera, so at least stop it ticking
+	if (IsNetMode(NM_DedicatedServer))
+	{
+		if (SpringArmComponent != nullptr)
+		{
+			SpringArmComponent->SetComponentTickEnabled(false);
+		}
+
+		if (CameraComponent != nullptr)
+		{
+			CameraComponent->Deactivate();
+		}
+	}
+}
+
+void AFGPlayer::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	Super::EndPlay(EndPlayReason);
+
+	if (ProxyMovement != nullptr)
+	{
+		ProxyMovement->UnregisterPlayer(this);
+	}
+
+	if (CorrectionTelemetry.IsValid())
+	{
+		FFGCorrectionTelemetry::UnregisterPlayer(CorrectionTelemetry);
+		CorrectionTelemetry.Reset();
+	}
 }
 
 void AFGPlayer::Tick(float DeltaTime)
 {
+	SCOPE_CYCLE_COUNTER(STAT_FGPlayerTick);
+	CSV_SCOPED_TIMING_STAT(FGNet, PlayerTick);
+
 	Super::Tick(DeltaTime);
 
 	FireCooldownElapsed -= DeltaTime;
 
+	if (HasAuthority() && !IsLocallyControlled() && IsPlayerControlled())
+	{
+		ServerFrameTimeSendTimer -= DeltaTime;
+		if (ServerFrameTimeSendTimer <= 0.0f)
+		{
+			ServerFrameTimeSendTimer = ServerFrameTimeInterval;
+			Client_SendServerFrameTime(FPlatformTime::ToMilliseconds(GGameThreadTime));
+		}
+
+		RttEchoTimer -= DeltaTime;
+		if (RttEchoTimer <= 0.0f && bHasMovementTimeStampToEcho)
+		{
+			RttEchoTimer = RttEchoInterval;
+			const int64 ServerTime = NetClock->GetNetworkTimeMicros();
+			{
+				FFGScopedRPCStat RPCStat(EFGNetRPCType::Movement, *this);
+				Client_EchoMovementTime(LastReceivedMovementTimeStamp, static_cast<int32>(ServerTime - LastMovementReceiveTime), ServerTime);
+			}
+			bHasMovementTimeStampToEcho = false;
+		}
+	}
+
+	// Also covers a listen server's own player, whose movement is relayed the same way
+	if (HasAuthority() && MovementScheduler.HasPendingViewers() && PlayerSettings != nullptr)
+	{
+		RelayHeldBackMovement();
+	}
+
 	if (!ensure(PlayerSettings != nullptr))
 	{
 		return;
 	}
 
-	FFGFrameMovement FrameMovement = MovementComponent->CreateFrameMovement();
-
-	if (IsLocallyControlled())
+	// Remote players are moved by UFGProxyMovementSubsystem in one batch after all actors have ticked
+	if (ProxyMovement != nullptr && ProxyMovement->IsBatching(*this))
 	{
-		ClientTimeStamp += DeltaTime;
+		return;
+	}
 
-		const float MaxVelocity = PlayerSettings->MaxVelocity;
-		const float Friction = IsBraking() ? PlayerSettings->BreakingFriction : PlayerSettings->DefaultFriction;
-		const float Alpha = FMath::Clamp(FMath::Abs(MovementVelocity / (MaxVelocity * 0.75f)), 0.0f, 1.0f);
-		const float TurnSpeed = FMath::InterpEaseOut(0.0f, PlayerSettings->TurnSpeedDefault, Alpha, 5.0f);
-		const float MovementDirection = MovementVelocity > 0.0f ? Turn : -Turn;
+	const float StepTime = GetSimulationStepTime();
+	SimulationTimeAccumulator += DeltaTime;
 
-		Yaw += (MovementDirection * TurnSpeed) * DeltaTime;
-		FQuat WantedFacingDirection = FQuat(FVector::UpVector, FMath::DegreesToRadians(Yaw));
-		MovementComponent->SetFacingRotation(WantedFacingDirection);
+	int32 NumSteps = 0;
+	while (SimulationTimeAccumulator >= StepTime && NumSteps < FFGMovementModel::MaxStepsPerFrame)
+	{
+		PreviousSimulationLocation = GetActorLocation();
+		SimulateStep(StepTime);
 
-		AddMovementVelocity(DeltaTime);
-		MovementVelocity *= FMath::Pow(Friction, DeltaTime);
+		if (IsLocallyControlled())
+		{
+			FFGMovementModel::Step(SentMovementPrediction, SentMovementInput, *PlayerSettings, StepTime);
+		}
 
-		MovementComponent->ApplyGravity();
-		FrameMovement.AddDelta(GetActorForwardVector() * MovementVelocity * DeltaTime);
-		MovementComponent->Move(FrameMovement);
+		SimulationTimeAccumulator -= StepTime;
+		NumSteps++;
+	}
 
-		Server_SendMovement(GetActorLocation(), ClientTimeStamp, Forward, NetSerializeYaw(GetActorRotation().Yaw));
+	// After a long hitch the time that couldn't be simulated is dropped instead of being caught up over the next frames
+	if (NumSteps == FFGMovementModel::MaxStepsPerFrame)
+	{
+		SimulationTimeAccumulator = FMath::Fmod(SimulationTimeAccumulator, StepTime);
 	}
-	else
+
+	if (IsLocallyControlled())
 	{
-		const float Friction = IsBraking() ? PlayerSettings->BreakingFriction : PlayerSettings->DefaultFriction;
-		MovementVelocity *= FMath::Pow(Friction, DeltaTime);
-		FrameMovement.AddDelta(GetActorForwardVector() * MovementVelocity * DeltaTime);
-		MovementComponent->Move(FrameMovement);
+		TimeSinceMovementSent += DeltaTime;
 
-		if (bPerformNetworkSmoothing)
+		if (NumSteps > 0 && ShouldSendMovement())
 		{
-			const FVector NewRelativeLocation = FMath::VInterpTo(MeshComponent->GetRelativeLocation(), OriginalMeshOffset, LastCorrectionDelta, GetAveragePing(GetPing()));
-			MeshComponent->SetRelativeLocation(NewRelativeLocation, false, nullptr, ETeleportType::TeleportPhysics);
+			SendMovement();
 		}
+	}
 
-		/*const FVector NewLocation = FMath::VInterpTo(GetActorLocation(), ReplicatedLocation, DeltaTime, PlayerSettings->NetworkInterpolationSpeed);
-		SetActorLocation(NewLocation);
-		MovementComponent->SetFacingRotation(FRotator(0.0f, ReplicatedYaw, 0.0f), 10.0f);
-		SetActorRotation(MovementComponent->GetFacingRotation());*/
+	if (!IsNetMode(NM_DedicatedServer))
+	{
+		UpdateRenderOffset(DeltaTime, StepTime);
 	}
 }
 
@@ -141,9 +241,11 @@ void AFGPlayer::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetim
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-	DOREPLIFETIME(AFGPlayer, ReplicatedYaw);
-	DOREPLIFETIME(AFGPlayer, ReplicatedLocation);
 	DOREPLIFETIME(AFGPlayer, RocketInstances);
+
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+	DOREPLIFETIME_WITH_PARAMS_FAST(AFGPlayer, GameplayState, Params);
 }
 
 void AFGPlayer::CreateDebugWidget()
@@ -256,14 +358,16 @@ void AFGPlayer::FireRocket()
 	{
 		if (HasAuthority())
 		{
-			Server_FireRocket(NewRocket, GetRocketStartLocation(), GetActorRotation());
-			BP_OnNumRocketsChanged(NumRockets);
+			Server_FireRocket(NewRocket, GetRocketStartLocation(), GetActorRotation().Yaw);
 		}
 		else
 		{
 			NumRockets--;
 			NewRocket->StartMoving(GetActorForwardVector(), GetRocketStartLocation());
-			Server_FireRocket(NewRocket, GetRocketStartLocation(), GetActorRotation());
+			{
+				FFGScopedRPCStat RPCStat(EFGNetRPCType::Fire, *this);
+				Server_FireRocket(NewRocket, GetRocketStartLocation(), GetActorRotation().Yaw);
+			}
 			BP_OnNumRocketsChanged(NumRockets);
 		}
 	}
@@ -283,23 +387,36 @@ int32 AFGPlayer::GetNumActiveRockets() const
 	return NumActive;
 }
 
-void AFGPlayer::Server_FireRocket_Implementation(AFGRocket* NewRocket, const FVector& RocketStartLocation, const FRotator& RocketFacingRotation)
+void AFGPlayer::Server_FireRocket_Implementation(AFGRocket* NewRocket, const FVector& RocketStartLocation, const FFGNetQuantizedYaw& RocketYaw)
 {
-	if ((ServerNumRockets - 1) < 0 && !bUnlimitedRockets)
+	const FRotator RocketFacingRotation = RocketYaw.ToRotator();
+	FFGNetRecorder::RecordFire(*this, RocketStartLocation, RocketFacingRotation);
+
+	if ((GameplayState.NumRockets - 1) < 0 && !bUnlimitedRockets)
 	{
-		Client_RemoveRocket(NewRocket, ServerNumRockets);
+		{
+			FFGScopedRPCStat RPCStat(EFGNetRPCType::Fire, *this);
+			Client_RemoveRocket(NewRocket);
+		}
+
+		// Resend the rocket count the client predicted wrong
+		++GameplayState.Revision;
+		MarkGameplayStateDirty();
 	}
 	else
 	{
 		const float DeltaYaw = FMath::FindDeltaAngleDegrees(RocketFacingRotation.Yaw, GetActorForwardVector().Rotation().Yaw);
 		const FRotator NewFacingRotation = RocketFacingRotation + FRotator(0.0f, DeltaYaw, 0.0f);
-		ServerNumRockets--;
-		Multicast_FireRocket(NewRocket, RocketStartLocation, NewFacingRotation);
+		SetGameplayState(GameplayState.Health, GameplayState.NumRockets - 1);
+		FFGScopedRPCStat RPCStat(EFGNetRPCType::Fire, GetNetDriver());
+		Multicast_FireRocket(NewRocket, RocketStartLocation, NewFacingRotation.Yaw, NetClock->GetNetworkTimeStamp());
 	}
 }
 
-void AFGPlayer::Multicast_FireRocket_Implementation(AFGRocket* NewRocket, const FVector& RocketStartLocation, const FRotator& RocketFacingRotation)
+void AFGPlayer::Multicast_FireRocket_Implementation(AFGRocket* NewRocket, const FVector& RocketStartLocation, const FFGNetQuantizedYaw& RocketYaw, uint32 ServerFireTime)
 {
+	const FRotator RocketFacingRotation = RocketYaw.ToRotator();
+
 	if (!ensure(NewRocket != nullptr))
 	{
 		return;
@@ -311,20 +428,22 @@ void AFGPlayer::Multicast_FireRocket_Implementation(AFGRocket* NewRocket, const
 	}
 	else
 	{
-		NumRockets--;
 		NewRocket->StartMoving(RocketFacingRotation.Vector(), RocketStartLocation);
-	}
 
-	if (!IsLocallyControlled())
-	{
-		BP_OnNumRocketsChanged(NumRockets);
+		// Catch up with the server's rocket, which has been flying for as long as this event took to arrive
+		if (!HasAuthority() && NetClock->IsSynchronized())
+		{
+			NewRocket->FastForward(FMath::Max(UFGNetClockSubsystem::GetDeltaSeconds(NetClock->GetNetworkTimeStamp(), ServerFireTime), 0.0f));
+		}
 	}
 }
 
-void AFGPlayer::Client_RemoveRocket_Implementation(AFGRocket* RocketToRemove, int RocketAmount)
+void AFGPlayer::Client_RemoveRocket_Implementation(AFGRocket* RocketToRemove)
 {
-	RocketToRemove->MakeFree();
-	NumRockets = RocketAmount;
+	if (RocketToRemove != nullptr)
+	{
+		RocketToRemove->MakeFree();
+	}
 }
 
 FVector AFGPlayer::GetRocketStartLocation() const
@@ -355,121 +474,314 @@ AFGRocket* AFGPlayer::GetFreeRocket() const
 
 #pragma region Movement
 
-void AFGPlayer::AddMovementVelocity(float DeltaTime)
+FFGMovementInput AFGPlayer::GetMovementInput() const
 {
-	if (!ensure(PlayerSettings != nullptr))
+	FFGMovementInput Input;
+	Input.Forward = Forward;
+	Input.Turn = Turn;
+	Input.bBrake = bBrake;
+	return Input;
+}
+
+float AFGPlayer::GetSimulationStepTime() const
+{
+	// The tick rate is config on the network clock so the server and its clients step the same way
+	return NetClock != nullptr ? NetClock->GetSimulationTickDuration() : DefaultSimulationStepTime;
+}
+
+void AFGPlayer::SimulateStep(float StepTime)
+{
+	// Remote players run the same step on the inputs from their latest movement update
+	const FFGMovementInput Input = GetMovementInput();
+	Yaw = FFGMovementModel::StepYaw(Yaw, MovementVelocity, Input, *PlayerSettings, StepTime);
+	MovementVelocity = FFGMovementModel::StepVelocity(MovementVelocity, Input, *PlayerSettings, StepTime);
+	MovementComponent->SetFacingYaw(Yaw);
+
+	FFGFrameMovement FrameMovement = MovementComponent->CreateFrameMovement();
+
+	if (IsLocallyControlled())
 	{
-		return;
+		MovementComponent->ApplyGravity(StepTime);
 	}
 
-	const float MaxVelocity = PlayerSettings->MaxVelocity;
-	const float Acceleration = PlayerSettings->Acceleration;
+	FrameMovement.AddDelta(GetActorForwardVector() * MovementVelocity * StepTime);
+	MovementComponent->Move(FrameMovement);
+}
 
-	MovementVelocity += Forward * Acceleration * DeltaTime;
-	MovementVelocity = FMath::Clamp(MovementVelocity, -MaxVelocity, MaxVelocity);
+bool AFGPlayer::ShouldSendMovement() const
+{
+	if (TimeSinceMovementSent >= PlayerSettings->MovementKeepAliveInterval)
+	{
+		return true;
+	}
+
+	const float DistanceError = FVector::DistSquared2D(SentMovementPrediction.Location, GetActorLocation());
+	const float YawError = FMath::Abs(FMath::FindDeltaAngleDegrees(SentMovementPrediction.Yaw, Yaw));
+
+	return DistanceError > FMath::Square(PlayerSettings->DeadReckoningDistanceThreshold) || YawError > PlayerSettings->DeadReckoningYawThreshold;
 }
 
-void AFGPlayer::Server_SendMovement_Implementation(const FVector& ClientLocation, float TimeStamp, float ClientForward, uint8 ClientYaw)
+void AFGPlayer::SendMovement()
 {
-	/*const float DeltaTime = FMath::Min(TimeStamp - ServerTimeStamp, MaxMoveDeltaTime);
-	ServerTimeStamp = TimeStamp;*/
+	const uint8 SentYaw = static_cast<uint8>(FFGNetQuantize::QuantizeYaw(Yaw, MovementYawBits));
+	{
+		FFGScopedRPCStat RPCStat(EFGNetRPCType::Movement, *this);
+		Server_SendMovement(GetActorLocation(), NetClock->RecordSentTimeStamp(), MovementVelocity, Forward, Turn, SentYaw, bBrake);
+	}
 
-	Multicast_SendMovement(ClientLocation, TimeStamp, ClientForward, ClientYaw);
+	// Predict from what was actually sent, so the yaw includes the quantization receivers see
+	SentMovementPrediction.Location = GetActorLocation();
+	SentMovementPrediction.Velocity = MovementVelocity;
+	SentMovementPrediction.Yaw = FFGNetQuantize::DequantizeYaw(SentYaw, MovementYawBits);
+	SentMovementInput = GetMovementInput();
+	TimeSinceMovementSent = 0.0f;
 }
 
-void AFGPlayer::Multicast_SendMovement_Implementation(const FVector& InClientLocation, float TimeStamp, float ClientForward, uint8 ClientYaw)
+float AFGPlayer::GetNetworkSmoothingTime() const
 {
-	if (!IsLocallyControlled())
+	// Spread corrections over about a round trip, longer on a jittery connection
+	const FFGRttEstimator* Estimator = FindConnectionRttEstimator();
+	return Estimator != nullptr && Estimator->HasSamples()
+		? FMath::Clamp(Estimator->GetSmoothedRtt() + 2.0f * Estimator->GetRttVariance(), MinSmoothingTime, MaxSmoothingTime)
+		: 1.0f / PlayerSettings->NetworkInterpolationSpeed;
+}
+
+void AFGPlayer::UpdateRenderOffset(float DeltaTime, float StepTime)
+{
+	if (!IsLocallyControlled() && bPerformNetworkSmoothing)
+	{
+		NetworkSmoothingOffset = FMath::VInterpTo(NetworkSmoothingOffset, FVector::ZeroVector, DeltaTime, 1.0f / GetNetworkSmoothingTime());
+	}
+
+	ApplyRenderOffset(StepTime);
+}
+
+void AFGPlayer::ApplyRenderOffset(float StepTime)
+{
+	// The actor sits at the latest simulated step, so draw the mesh back towards the previous one by the time left over
+	const float Alpha = FMath::Clamp(SimulationTimeAccumulator / StepTime, 0.0f, 1.0f);
+	const FVector InterpolationOffset = (PreviousSimulationLocation - GetActorLocation()) * (1.0f - Alpha);
+	const FVector RelativeOffset = GetActorTransform().InverseTransformVectorNoScale(InterpolationOffset + NetworkSmoothingOffset);
+	MeshComponent->SetRelativeLocation(OriginalMeshOffset + RelativeOffset, false, nullptr, ETeleportType::TeleportPhysics);
+
+	if (IsLocallyControlled() && SpringArmComponent != nullptr)
+	{
+		SpringArmComponent->SetRelativeLocation(OriginalSpringArmOffset + RelativeOffset);
+	}
+}
+
+void AFGPlayer::Server_SendMovement_Implementation(const FVector& ClientLocation, uint32 TimeStamp, float ClientVelocity, float ClientForward, float ClientTurn, uint8 ClientYaw, bool bClientBrake)
+{
+	SCOPE_CYCLE_COUNTER(STAT_FGServerSendMovement);
+	CSV_SCOPED_TIMING_STAT(FGNet, ServerSendMovement);
+
+	FFGNetRecorder::RecordMovement(*this, ClientLocation, TimeStamp, ClientVelocity, ClientForward, ClientTurn, ClientYaw, bClientBrake);
+
+	LastReceivedMovementTimeStamp = TimeStamp;
+	LastMovementReceiveTime = NetClock->GetNetworkTimeMicros();
+	bHasMovementTimeStampToEcho = true;
+
+	ApplyRemoteMovement(ClientLocation, TimeStamp, ClientVelocity, ClientForward, ClientTurn, ClientYaw, bClientBrake);
+
+	if (Snapshots != nullptr && Snapshots->IsEnabled())
+	{
+		Snapshots->RecordMovement(*this, ClientLocation, TimeStamp, ClientVelocity, ClientForward, ClientTurn, ClientYaw, bClientBrake);
+		return;
+	}
+
+	if (!ensure(PlayerSettings != nullptr))
+	{
+		return;
+	}
+
+	if (MovementScheduler.GetNumViewers() > GetWorld()->GetNumPlayerControllers())
 	{
-		Forward = ClientForward;
-		const float DeltaTime = FMath::Min(TimeStamp - ClientTimeStamp, MaxMoveDeltaTime);
-		ClientTimeStamp = TimeStamp;
+		MovementScheduler.RemoveStaleViewers();
+	}
 
-		AddMovementVelocity(DeltaTime);
-		MovementComponent->SetFacingRotation(FRotator(0.0f, NetUnserializeYaw(ClientYaw), 0.0f));
+	LatestRelayedMovement.Location = ClientLocation;
+	LatestRelayedMovement.TimeStamp = TimeStamp;
+	LatestRelayedMovement.Velocity = ClientVelocity;
+	LatestRelayedMovement.Forward = ClientForward;
+	LatestRelayedMovement.Turn = ClientTurn;
+	LatestRelayedMovement.Yaw = ClientYaw;
+	LatestRelayedMovement.bBrake = bClientBrake;
 
-		const FVector DeltaDiff = InClientLocation - GetActorLocation();
+	const float CurrentTime = GetWorld()->GetTimeSeconds();
 
-		if (DeltaDiff.SizeSquared() > FMath::Square(80.0f))
+	for (FConstPlayerControllerIterator Iterator = GetWorld()->GetPlayerControllerIterator(); Iterator; ++Iterator)
+	{
+		const APlayerController* PlayerController = Iterator->Get();
+
+		if (PlayerController == nullptr || PlayerController == GetController() || PlayerController->IsLocalController())
 		{
-			if (bPerformNetworkSmoothing)
-			{
-				const FScopedPreventAttachedComponentMove PreventMeshMove(MeshComponent);
-				MovementComponent->UpdatedComponent->SetWorldLocation(InClientLocation, false, nullptr, ETeleportType::TeleportPhysics);
-				LastCorrectionDelta = DeltaTime;
-			}
-			else
-			{
-				SetActorLocation(InClientLocation);
-			}
+			continue;
+		}
+
+		AFGPlayer* Viewer = Cast<AFGPlayer>(PlayerController->GetPawn());
+
+		if (Viewer != nullptr && MovementScheduler.ShouldSendTo(*this, *Viewer, CurrentTime, *PlayerSettings))
+		{
+			RelayMovementTo(*Viewer);
 		}
 	}
 }
 
-uint8 AFGPlayer::NetSerializeYaw(float InYaw)
+void AFGPlayer::RelayHeldBackMovement()
 {
-	return FMath::RoundToInt(InYaw * 256.f / 360.f) & 0xFF;
+	TArray<AFGPlayer*> Viewers;
+	MovementScheduler.TakeDueViewers(*this, GetWorld()->GetTimeSeconds(), *PlayerSettings, Viewers);
+
+	for (AFGPlayer* Viewer : Viewers)
+	{
+		RelayMovementTo(*Viewer);
+	}
 }
 
-float AFGPlayer::NetUnserializeYaw(uint8 InYaw)
+void AFGPlayer::RelayMovementTo(AFGPlayer& Viewer)
 {
-	return (InYaw * 360.f / 256.f);
+	const FFGRelayedMovement& Movement = LatestRelayedMovement;
+	FFGScopedRPCStat RPCStat(EFGNetRPCType::Movement, Viewer);
+	Viewer.Client_SendMovement(this, Movement.Location, Movement.TimeStamp, Movement.Velocity, Movement.Forward, Movement.Turn, Movement.Yaw, Movement.bBrake);
 }
 
-void AFGPlayer::Server_SendLocation_Implementation(const FVector& LocationToSend)
+void AFGPlayer::Client_SendMovement_Implementation(AFGPlayer* MovingPlayer, const FVector& InClientLocation, uint32 TimeStamp, float ClientVelocity, float ClientForward, float ClientTurn, uint8 ClientYaw, bool bClientBrake)
 {
-	ReplicatedLocation = LocationToSend;
+	// The moving player may not be relevant to this connection yet
+	if (MovingPlayer != nullptr)
+	{
+		MovingPlayer->ApplyRemoteMovement(InClientLocation, TimeStamp, ClientVelocity, ClientForward, ClientTurn, ClientYaw, bClientBrake);
+	}
 }
 
-void AFGPlayer::Multicast_SendLocation_Implementation(const FVector& LocationToSend)
+void AFGPlayer::Client_ReceiveSnapshot_Implementation(const FFGSnapshotPayload& Payload)
 {
-	if (!IsLocallyControlled())
+	if (Snapshots != nullptr)
 	{
-		SetActorLocation(LocationToSend);
+		Snapshots->ReceiveSnapshot(*this, Payload);
 	}
 }
 
-void AFGPlayer::Server_SendFaceDirection_Implementation(const FQuat& FaceDirectionToSend)
+void AFGPlayer::Server_AckSnapshot_Implementation(uint16 SnapshotId)
 {
-	Multicast_SendFaceDirection(FaceDirectionToSend);
+	if (Snapshots != nullptr)
+	{
+		Snapshots->AcknowledgeSnapshot(*this, SnapshotId);
+	}
 }
 
-void AFGPlayer::Multicast_SendFaceDirection_Implementation(const FQuat& FaceDirectionToSend)
+void AFGPlayer::ApplyRemoteMovement(const FVector& InClientLocation, FFGNetTimeStamp TimeStamp, float ClientVelocity, float ClientForward, float ClientTurn, uint8 ClientYaw, bool bClientBrake)
 {
-	if (!IsLocallyControlled())
+	SCOPE_CYCLE_COUNTER(STAT_FGApplyRemoteMovement);
+
+	if (IsLocallyControlled() || !ensure(PlayerSettings != nullptr))
 	{
-		MovementComponent->SetFacingRotation(FaceDirectionToSend);
+		return;
+	}
+
+	// Updates carry the full state, so one that arrives after a newer one has nothing to add
+	if (bHasRemoteTimeStamp && UFGNetClockSubsystem::GetDeltaSeconds(TimeStamp, LastRemoteTimeStamp) < 0.0f)
+	{
+		return;
+	}
+
+	LastRemoteTimeStamp = TimeStamp;
+	bHasRemoteTimeStamp = true;
+
+	Forward = ClientForward;
+	Turn = ClientTurn;
+	bBrake = bClientBrake;
+
+	FFGMovementModelState State;
+	State.Location = InClientLocation;
+	State.Velocity = ClientVelocity;
+	State.Yaw = FFGNetQuantize::DequantizeYaw(ClientYaw, MovementYawBits);
+
+	// Clients catch up on the time the update spent travelling, which is what the sender predicts they show.
+	// The server keeps players where they reported being.
+	if (!NetClock->IsAuthority() && NetClock->IsSynchronized())
+	{
+		const float StepTime = GetSimulationStepTime();
+		const FFGMovementInput Input = GetMovementInput();
+		float Age = FMath::Min(UFGNetClockSubsystem::GetDeltaSeconds(NetClock->GetNetworkTimeStamp(), TimeStamp), MaxRemoteCatchUpTime);
+
+		for (; Age >= StepTime; Age -= StepTime)
+		{
+			FFGMovementModel::Step(State, Input, *PlayerSettings, StepTime);
+		}
+	}
+
+	MovementVelocity = State.Velocity;
+	Yaw = State.Yaw;
+	MovementComponent->SetFacingYaw(Yaw);
+
+	const FVector DeltaDiff = State.Location - GetActorLocation();
+	const bool bShouldSnap = DeltaDiff.SizeSquared() > FMath::Square(PlayerSettings->CorrectionSnapDistance);
+
+	if (!CorrectionTelemetry.IsValid())
+	{
+		CorrectionTelemetry = FFGCorrectionTelemetry::RegisterPlayer(GetPlayerState() != nullptr ? GetPlayerState()->GetPlayerName() : GetName());
+	}
+
+	FFGCorrectionTelemetry::RecordMovementUpdate(*CorrectionTelemetry, DeltaDiff.Size(), bShouldSnap, GetWorld()->GetTimeSeconds());
+
+	if (bShouldSnap)
+	{
+		FFGLoadTestRecorder::NotifyCorrection();
+	}
+
+	// Updates are sparse, so every one is applied. The player keeps being drawn where it was and the offset is eased out
+	// in UpdateRenderOffset.
+	MovementComponent->UpdatedComponent->SetWorldLocation(State.Location, false, nullptr, ETeleportType::TeleportPhysics);
+	PreviousSimulationLocation += DeltaDiff;
+
+	if (bPerformNetworkSmoothing && !IsNetMode(NM_DedicatedServer))
+	{
+		NetworkSmoothingOffset -= DeltaDiff;
 	}
 }
 
-void AFGPlayer::Server_SendYaw_Implementation(float NewYaw)
+void AFGPlayer::Client_SendServerFrameTime_Implementation(float FrameTimeMs)
 {
-	ReplicatedYaw = NewYaw;
+	ServerFrameTimeMs = FrameTimeMs;
 }
 
-float AFGPlayer::GetAveragePing(int32 NewPing)
+void AFGPlayer::Client_EchoMovementTime_Implementation(uint32 EchoedTimeStamp, int32 ServerHoldMicros, int64 ServerTimeMicros)
 {
-	float AveragepingSum = NewPing;
-
-	if (LastFramePing != 0)
+	// Sent time stamps are on the network clock, which is being adjusted by these samples, so measure against the local clock
+	int64 LocalSendTime = 0;
+	if (NetClock->FindLocalSendTime(EchoedTimeStamp, LocalSendTime))
 	{
-		AveragepingSum += LastFramePing;
+		RttEstimator.AddSample(LocalSendTime, ServerTimeMicros - ServerHoldMicros, ServerTimeMicros, NetClock->GetLocalTimeMicros());
+		NetClock->SetTargetOffset(RttEstimator.GetClockOffset());
 	}
 
-	if (TwoFramesAgoPing != 0)
+	// Answered straight away so the server gets an estimate of its own, once this clock's stamps are in the server's range
+	if (NetClock->IsSynchronized())
 	{
-		AveragepingSum += TwoFramesAgoPing;
+		FFGScopedRPCStat RPCStat(EFGNetRPCType::Movement, *this);
+		Server_EchoServerTime(static_cast<FFGNetTimeStamp>(ServerTimeMicros), NetClock->GetNetworkTimeStamp());
 	}
+}
 
-	TwoFramesAgoPing = LastFramePing;
-	LastFramePing = NewPing;
+void AFGPlayer::Server_EchoServerTime_Implementation(uint32 ServerTime, uint32 ClientTime)
+{
+	// The offset found here is how far the client's network clock is from the server's
+	const int64 ClientTimeMicros = NetClock->ExpandTimeStamp(ClientTime);
+	RttEstimator.AddSample(NetClock->ExpandTimeStamp(ServerTime), ClientTimeMicros, ClientTimeMicros, NetClock->GetNetworkTimeMicros());
+}
+
+void AFGPlayer::Server_SendFaceDirection_Implementation(const FFGNetQuantizedYaw& FaceYaw)
+{
+	Multicast_SendFaceDirection(FaceYaw);
+}
 
-	if (AveragepingSum == 0)
+void AFGPlayer::Multicast_SendFaceDirection_Implementation(const FFGNetQuantizedYaw& FaceYaw)
+{
+	if (!IsLocallyControlled())
 	{
-		return 0;
+		MovementComponent->SetFacingYaw(FaceYaw.Yaw);
 	}
-
-	return AveragepingSum / 3;
 }
 
 #pragma endregion Movement
@@ -482,25 +794,11 @@ void AFGPlayer::HitPlayerWithRocket(AFGRocket* Rocket)
 	{
 		if (HasAuthority())
 		{
-			// Reduce health
-			--ServerHealth;
-			Multicast_HitByRocket(Rocket);
+			SetGameplayState(GameplayState.Health - 1, GameplayState.NumRockets);
 		}
 	}
 }
 
-void AFGPlayer::RevertHealth()
-{
-	--Health;
-	BP_OnHealthChanged(Health);
-}
-
-void AFGPlayer::Multicast_HitByRocket_Implementation(AFGRocket* Rocket)
-{
-	--Health;
-	BP_OnHealthChanged(Health);
-}
-
 #pragma endregion RocketHits
 
 #pragma region Pickups
@@ -525,6 +823,8 @@ void AFGPlayer::OnPickup(AFGPickup* Pickup)
 		else if (IsLocallyControlled())
 		{
 			Pickup->HidePickup();
+			PredictedPickup = Pickup;
+			PredictedPickupRevision = GameplayState.Revision;
 
 			if (Pickup->PickupType == EFGPickupType::Rocket)
 			{
@@ -537,6 +837,7 @@ void AFGPlayer::OnPickup(AFGPickup* Pickup)
 				BP_OnHealthChanged(Health);
 			}
 
+			FFGScopedRPCStat RPCStat(EFGNetRPCType::Pickup, *this);
 			Server_OnPickup(Pickup);
 		}
 	}
@@ -544,69 +845,69 @@ void AFGPlayer::OnPickup(AFGPickup* Pickup)
 
 void AFGPlayer::HandleRocketPickup(AFGPickup* Pickup)
 {
-	ServerNumRockets += Pickup->NumRockets;
-	Multicast_OnPickupRockets(Pickup, ServerNumRockets);
+	SetGameplayState(GameplayState.Health, GameplayState.NumRockets + Pickup->NumRockets);
 }
 
 void AFGPlayer::HandleHealthPickup(AFGPickup* Pickup)
 {
-	ServerHealth += Pickup->NumRockets;
-	Multicast_OnPickupHealth(Pickup, ServerHealth);
+	SetGameplayState(GameplayState.Health + Pickup->NumRockets, GameplayState.NumRockets);
 }
 
 void AFGPlayer::Server_OnPickup_Implementation(AFGPickup* Pickup)
 {
-	if (Pickup->IsPickedUp())
-	{
-		Client_OnPickup(true, Pickup);
-	}
-	Client_OnPickup(Pickup->IsPickedUp(), Pickup);
+	// Either the server's own overlap already granted the pickup or it was rejected, so the client only needs the current state
+	++GameplayState.Revision;
+	MarkGameplayStateDirty();
 }
 
-void AFGPlayer::Client_OnPickup_Implementation(bool ConfirmedPickup, AFGPickup* Pickup)
+#pragma endregion Pickups
+
+#pragma region GameplayState
+
+void AFGPlayer::SetGameplayState(int32 NewHealth, int32 NewNumRockets)
 {
-	if (!ConfirmedPickup)
-	{
-		if (Pickup->PickupType == EFGPickupType::Rocket)
-		{
-			NumRockets -= Pickup->NumRockets;
-			BP_OnNumRocketsChanged(NumRockets);
-		}
-		else if (Pickup->PickupType == EFGPickupType::Health)
-		{
-			Health -= Pickup->NumRockets;
-			BP_OnHealthChanged(Health);
-		}
+	check(HasAuthority());
 
-		Pickup->ShowPickup();
-	}
+	GameplayState.Health = FMath::Clamp<int32>(NewHealth, MIN_int16, MAX_int16);
+	GameplayState.NumRockets = FMath::Clamp<int32>(NewNumRockets, 0, MAX_int16);
+	MarkGameplayStateDirty();
+
+	// The server doesn't receive its own OnRep
+	OnRep_GameplayState();
 }
 
-void AFGPlayer::Multicast_OnPickupRockets_Implementation(AFGPickup* Pickup, int32 NewRocketAmount)
+void AFGPlayer::MarkGameplayStateDirty()
 {
-	NumRockets = NewRocketAmount;
-	BP_OnNumRocketsChanged(NumRockets);
-
-	Pickup->HandlePickup();
+	MARK_PROPERTY_DIRTY_FROM_NAME(AFGPlayer, GameplayState, this);
 }
 
-void AFGPlayer::Multicast_OnPickupHealth_Implementation(AFGPickup* Pickup, int32 NewHealth)
+void AFGPlayer::OnRep_GameplayState()
 {
-	Health = NewHealth;
-	BP_OnHealthChanged(Health);
+	if (Health != GameplayState.Health)
+	{
+		Health = GameplayState.Health;
+		BP_OnHealthChanged(Health);
+	}
 
-	if (IsLocallyControlled())
+	if (NumRockets != GameplayState.NumRockets)
+	{
+		NumRockets = GameplayState.NumRockets;
+		BP_OnNumRocketsChanged(NumRockets);
+	}
+
+	// A new revision means the server has answered the predicted pickup, so show it again if it wasn't granted
+	if (PredictedPickup.IsValid() && GameplayState.Revision != PredictedPickupRevision)
 	{
-		if (const UWorld* World = GetWorld())
+		if (!PredictedPickup->IsPickedUp())
 		{
-			World->GetTimerManager().ClearTimer(HealthRevertHandle);
+			PredictedPickup->ShowPickup();
 		}
-	}
 
-	Pickup->HandlePickup();
+		PredictedPickup.Reset();
+	}
 }
 
-#pragma endregion Pickups
+#pragma endregion GameplayState
 
 #pragma region DebugMenu
 
@@ -640,6 +941,11 @@ void AFGPlayer::HideDebugMenu()
 
 int32 AFGPlayer::GetPing() const
 {
+	if (RttEstimator.HasSamples())
+	{
+		return FMath::RoundToInt(RttEstimator.GetSmoothedRtt() * 1000.0f);
+	}
+
 	if (GetPlayerState())
 	{
 		return static_cast<int32>(GetPlayerState()->GetPing());
@@ -648,6 +954,28 @@ int32 AFGPlayer::GetPing() const
 	return 0;
 }
 
+float AFGPlayer::GetSmoothedRttMs() const
+{
+	return RttEstimator.GetSmoothedRtt() * 1000.0f;
+}
+
+float AFGPlayer::GetJitterMs() const
+{
+	return RttEstimator.GetJitter() * 1000.0f;
+}
+
+const FFGRttEstimator* AFGPlayer::FindConnectionRttEstimator() const
+{
+	if (HasAuthority() || IsLocallyControlled())
+	{
+		return &RttEstimator;
+	}
+
+	const APlayerController* LocalController = GetWorld()->GetFirstPlayerController();
+	const AFGPlayer* LocalPlayer = LocalController != nullptr ? LocalController->GetPawn<AFGPlayer>() : nullptr;
+	return LocalPlayer != nullptr ? &LocalPlayer->RttEstimator : nullptr;
+}
+
 void AFGPlayer::Cheat_IncreaseRockets(int32 InNumRockets)
 {
 	if (IsLocallyControlled())
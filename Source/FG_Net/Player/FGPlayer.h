@@ -1,6 +1,12 @@
 #pragma once
 
 #include "GameFramework/Pawn.h"
+#include "FGMovementPriorityScheduler.h"
+#include "FGMovementModel.h"
+#include "../Network/FGRttEstimator.h"
+#include "../Network/FGNetClock.h"
+#include "../Network/FGNetQuantize.h"
+#include "../Network/FGSnapshotSubsystem.h"
 #include "FGPlayer.generated.h"
 
 class UCameraComponent;
@@ -10,13 +16,37 @@ class UStaticMeshComponent;
 class USphereComponent;
 class UFGPlayerSettings;
 class UFGNetDebugWidget;
+class UFGProxyMovementSubsystem;
+class UFGSnapshotSubsystem;
 class AFGRocket;
 class AFGPickup;
+struct FFGPlayerCorrectionTelemetry;
+
+// Server-owned gameplay state, replicated push-based so it is only compared after MarkGameplayStateDirty
+USTRUCT()
+struct FFGPlayerGameplayState
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	int16 Health = 3;
+
+	UPROPERTY()
+	int16 NumRockets = 0;
+
+	// Bumped when the owning client needs the current state again even though nothing changed, e.g. a rejected pickup
+	UPROPERTY()
+	uint8 Revision = 0;
+};
 
 UCLASS()
 class FG_NET_API AFGPlayer : public APawn
 {
 	GENERATED_BODY()
+	friend class UFGBotComponent;
+	friend class FFGNetReplay;
+	friend class UFGProxyMovementSubsystem;
+	friend class UFGSnapshotSubsystem;
 private:
 	float Forward = 0.0f;
 	float Turn = 0.0f;
@@ -27,40 +57,84 @@ private:
 	bool bBrake = false;
 	bool bShowDebugMenu = false;
 
-	float ClientTimeStamp = 0.0f;
-	float LastCorrectionDelta = 0.0f;
-	float ServerTimeStamp = 0.0f;
+	// Network time stamp of the latest movement update applied to this remote player
+	FFGNetTimeStamp LastRemoteTimeStamp = 0;
+	bool bHasRemoteTimeStamp = false;
+
+	UPROPERTY(Transient)
+	UFGNetClockSubsystem* NetClock = nullptr;
+
+	UPROPERTY(Transient)
+	UFGProxyMovementSubsystem* ProxyMovement = nullptr;
+
+	UPROPERTY(Transient)
+	UFGSnapshotSubsystem* Snapshots = nullptr;
 
 	UPROPERTY(EditAnywhere, Category = Network)
 	bool bPerformNetworkSmoothing = true;
 
 	FVector OriginalMeshOffset = FVector::ZeroVector;
+	FVector OriginalSpringArmOffset = FVector::ZeroVector;
 
-	UPROPERTY(Replicated)
-	float ReplicatedYaw = 0.0f;
+	// Movement is simulated in fixed steps of the network clock's tick rate, and drawn between the last two steps
+	float SimulationTimeAccumulator = 0.0f;
+	FVector PreviousSimulationLocation = FVector::ZeroVector;
+	// World space offset from a remote player's simulated location to where it was drawn before its last correction
+	FVector NetworkSmoothingOffset = FVector::ZeroVector;
 
-	UPROPERTY(Replicated)
-	FVector ReplicatedLocation;
+	// What other machines predict from the last movement update this player sent
+	FFGMovementModelState SentMovementPrediction;
+	FFGMovementInput SentMovementInput;
+	float TimeSinceMovementSent = BIG_NUMBER;
 
 	UPROPERTY(Replicated, Transient)
 	TArray<AFGRocket*> RocketInstances;
 
 	FVector DesiredLocation = FVector::ZeroVector;
 
-	int32 ServerNumRockets = 0;
+	UPROPERTY(ReplicatedUsing = OnRep_GameplayState)
+	FFGPlayerGameplayState GameplayState;
+
+	// Locally predicted values, overwritten whenever GameplayState arrives
 	int32 NumRockets = 0;
-	int32 ServerHealth = 3;
 	int32 Health = 3;
-	FTimerHandle HealthRevertHandle;
-	FTimerHandle RocketRevertHandle;
 
-	int32 LastFramePing = 0;
-	int32 TwoFramesAgoPing = 0;
+	// Pickup the owning client hid before the server confirmed it
+	TWeakObjectPtr<AFGPickup> PredictedPickup;
+	uint8 PredictedPickupRevision = 0;
+
+	// On the server this measures the owning client's connection, on the owning client the connection to the server
+	FFGRttEstimator RttEstimator;
+	FFGNetTimeStamp LastReceivedMovementTimeStamp = 0;
+	int64 LastMovementReceiveTime = 0;
+	bool bHasMovementTimeStampToEcho = false;
+	float RttEchoTimer = 0.0f;
+
+	// Sent by the server at a low rate for the debug widget's graphs
+	float ServerFrameTimeMs = 0.0f;
+	float ServerFrameTimeSendTimer = 0.0f;
+
+	// Server only, used when relaying movement to other connections
+	FFGMovementPriorityScheduler MovementScheduler;
+	FFGMovementBandwidthBudget MovementBandwidthBudget;
+	FFGRelayedMovement LatestRelayedMovement;
+
+	// Registered on the first remote movement update
+	TSharedPtr<FFGPlayerCorrectionTelemetry, ESPMode::ThreadSafe> CorrectionTelemetry;
 
 	FVector GetRocketStartLocation() const;
 	AFGRocket* GetFreeRocket() const;
 
-	void AddMovementVelocity(float DeltaTime);
+	FFGMovementInput GetMovementInput() const;
+	float GetSimulationStepTime() const;
+	void SimulateStep(float StepTime);
+	bool ShouldSendMovement() const;
+	void SendMovement();
+	void RelayHeldBackMovement();
+	void RelayMovementTo(AFGPlayer& Viewer);
+	float GetNetworkSmoothingTime() const;
+	void UpdateRenderOffset(float DeltaTime, float StepTime);
+	void ApplyRenderOffset(float StepTime);
 
 	UPROPERTY(VisibleDefaultsOnly, Category = Collision)
 	USphereComponent* CollisionComponent;
@@ -105,18 +179,20 @@ private:
 	void CreateDebugWidget();
 	void ShowDebugMenu();
 	void HideDebugMenu();
-	void RevertHealth();
+
+	UFUNCTION()
+	void OnRep_GameplayState();
+	void SetGameplayState(int32 NewHealth, int32 NewNumRockets);
+	void MarkGameplayStateDirty();
 
 	void HandleRocketPickup(AFGPickup* Pickup);
 	void HandleHealthPickup(AFGPickup* Pickup);
 
-	uint8 NetSerializeYaw(float InYaw);
-	float NetUnserializeYaw(uint8 InYaw);
-
-	float GetAveragePing(int32 NewPing);
+	void ApplyRemoteMovement(const FVector& InClientLocation, FFGNetTimeStamp TimeStamp, float ClientVelocity, float ClientForward, float ClientTurn, uint8 ClientYaw, bool bClientBrake);
 
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 public:
 	virtual void Tick(float DeltaTime) override;
@@ -124,11 +200,22 @@ public:
 
 	void OnPickup(AFGPickup* Pickup);
 
+	FFGMovementBandwidthBudget& GetMovementBandwidthBudget() { return MovementBandwidthBudget; }
+
 	UFUNCTION(BlueprintPure)
 	bool IsBraking() const { return bBrake; }
 	UFUNCTION(BlueprintPure)
 	int32 GetPing() const;
 	UFUNCTION(BlueprintPure)
+	float GetSmoothedRttMs() const;
+	UFUNCTION(BlueprintPure)
+	float GetJitterMs() const;
+
+	const FFGRttEstimator& GetRttEstimator() const { return RttEstimator; }
+	// Estimator for the connection this player's updates arrive over, which is the local player's own on clients
+	const FFGRttEstimator* FindConnectionRttEstimator() const;
+	float GetServerFrameTime() const { return ServerFrameTimeMs; }
+	UFUNCTION(BlueprintPure)
 	int32 GetNumRockets() const { return NumRockets; }
 	UFUNCTION(BlueprintImplementableEvent, Category = Player, meta = (DisplayName = "On Num Rockets Changed"))
 	void BP_OnNumRocketsChanged(int32 NewNumRockets);
@@ -142,47 +229,51 @@ public:
 	void HitPlayerWithRocket(AFGRocket* Rocket);
 
 	UFUNCTION(Server, Unreliable)
-	void Server_SendLocation(const FVector& LocationToSend);
-
-	UFUNCTION(NetMulticast, Unreliable)
-	void Multicast_SendLocation(const FVector& LocationToSend);
-
-	UFUNCTION(Server, Unreliable)
-	void Server_SendYaw(float NewYaw);
-
-	UFUNCTION(Server, Unreliable)
-	void Server_SendFaceDirection(const FQuat& LocationToSend);
+	void Server_SendFaceDirection(const FFGNetQuantizedYaw& FaceYaw);
 
 	UFUNCTION(NetMulticast, Unreliable)
-	void Multicast_SendFaceDirection(const FQuat& LocationToSend);
+	void Multicast_SendFaceDirection(const FFGNetQuantizedYaw& FaceYaw);
 
 	UFUNCTION(Server, Reliable)
 	void Server_OnPickup(AFGPickup* Pickup);
-	UFUNCTION(Client, Reliable)
-	void Client_OnPickup(bool ConfirmedPickup, AFGPickup* Pickup);
-	UFUNCTION(NetMulticast, Reliable)
-	void Multicast_OnPickupRockets(AFGPickup* Pickup, int32 NewRocketAmount);
-	UFUNCTION(NetMulticast, Reliable)
-	void Multicast_OnPickupHealth(AFGPickup* Pickup, int32 NewHealth);
 
 	UFUNCTION(Server, Reliable)
-	void Server_FireRocket(AFGRocket* NewRocket, const FVector& RocketStartLocation, const FRotator& RocketFacingRotation);
+	void Server_FireRocket(AFGRocket* NewRocket, const FVector& RocketStartLocation, const FFGNetQuantizedYaw& RocketYaw);
 
+	// ServerFireTime is the FFGNetTimeStamp the server fired at
 	UFUNCTION(NetMulticast, Reliable)
-	void Multicast_FireRocket(AFGRocket* NewRocket, const FVector& RocketStartLocation, const FRotator& RocketFacingRotation);
+	void Multicast_FireRocket(AFGRocket* NewRocket, const FVector& RocketStartLocation, const FFGNetQuantizedYaw& RocketYaw, uint32 ServerFireTime);
 
-	UFUNCTION(Client, Reliable)
-	void Client_RemoveRocket(AFGRocket* RocketToRemove, int RocketAmount);
-
-	UFUNCTION(NetMulticast, Reliable)
-	void Multicast_HitByRocket(AFGRocket* Rocket);
+	// The rocket count itself is corrected through GameplayState
+	UFUNCTION(Client, Unreliable)
+	void Client_RemoveRocket(AFGRocket* RocketToRemove);
 
 	UFUNCTION(BlueprintCallable)
 	void Cheat_IncreaseRockets(int32 InNumRockets);
 
+	UFUNCTION(Client, Unreliable)
+	void Client_SendServerFrameTime(float FrameTimeMs);
+
+	// Echoes the time stamp of the latest movement update, with how long the server held on to it.
+	// The server's time is sent in full, a client can't expand a 32 bit stamp before its clock has an offset.
+	UFUNCTION(Client, Unreliable)
+	void Client_EchoMovementTime(uint32 EchoedTimeStamp, int32 ServerHoldMicros, int64 ServerTimeMicros);
+
 	UFUNCTION(Server, Unreliable)
-	void Server_SendMovement(const FVector& ClientLocation, float TimeStamp, float ClientForward, uint8 ClientYaw);
+	void Server_EchoServerTime(uint32 ServerTime, uint32 ClientTime);
 
-	UFUNCTION(NetMulticast, Unreliable)
-	void Multicast_SendMovement(const FVector& InClientLocation, float TimeStamp, float ClientForward, uint8 ClientYaw);
+	// Sent when the receivers' prediction of this player drifts too far, see ShouldSendMovement
+	UFUNCTION(Server, Unreliable)
+	void Server_SendMovement(const FVector& ClientLocation, uint32 TimeStamp, float ClientVelocity, float ClientForward, float ClientTurn, uint8 ClientYaw, bool bClientBrake);
+
+	// Sent to every viewing connection except the one owning MovingPlayer
+	UFUNCTION(Client, Unreliable)
+	void Client_SendMovement(AFGPlayer* MovingPlayer, const FVector& InClientLocation, uint32 TimeStamp, float ClientVelocity, float ClientForward, float ClientTurn, uint8 ClientYaw, bool bClientBrake);
+
+	// Takes the place of Client_SendMovement when snapshots are enabled, see UFGSnapshotSubsystem
+	UFUNCTION(Client, Unreliable)
+	void Client_ReceiveSnapshot(const FFGSnapshotPayload& Payload);
+
+	UFUNCTION(Server, Unreliable)
+	void Server_AckSnapshot(uint16 SnapshotId);
 };
\ No newline at end of file
@@ -20,6 +20,32 @@ public:
 	float BreakingFriction = 0.001f;
 	UPROPERTY(EditAnywhere, Category = Movement)
 	float NetworkInterpolationSpeed = 10.0f;
+	// Remote players closer than this get every movement update
+	UPROPERTY(EditAnywhere, Category = Network, meta = (ClampMin = 0.0))
+	float NearUpdateDistance = 3000.0f;
+	// Remote players further away than this are sent at MinRemoteUpdateRate
+	UPROPERTY(EditAnywhere, Category = Network, meta = (ClampMin = 0.0))
+	float FarUpdateDistance = 15000.0f;
+	UPROPERTY(EditAnywhere, Category = Network, meta = (ClampMin = 1.0))
+	float MinRemoteUpdateRate = 4.0f;
+	// Players within this cone of the viewer's view direction count as on screen and are decimated half as much
+	UPROPERTY(EditAnywhere, Category = Network, meta = (ClampMin = -1.0, ClampMax = 1.0))
+	float OnScreenViewDot = 0.5f;
+	// Bytes per second of movement updates a single connection may receive
+	UPROPERTY(EditAnywhere, Category = Network, meta = (ClampMin = 0))
+	int32 MovementBandwidthBudget = 16000;
+	// Remote players further than this from where their update says they should be are snapped into place
+	UPROPERTY(EditAnywhere, Category = Network, meta = (ClampMin = 0.0))
+	float CorrectionSnapDistance = 80.0f;
+	// Movement is only sent once the location other machines predict is further than this from the real one
+	UPROPERTY(EditAnywhere, Category = Network, meta = (ClampMin = 0.0))
+	float DeadReckoningDistanceThreshold = 20.0f;
+	// As above, for the predicted yaw in degrees
+	UPROPERTY(EditAnywhere, Category = Network, meta = (ClampMin = 0.0))
+	float DeadReckoningYawThreshold = 5.0f;
+	// Longest time between movement updates, even when the prediction holds
+	UPROPERTY(EditAnywhere, Category = Network, meta = (ClampMin = 0.0))
+	float MovementKeepAliveInterval = 0.5f;
 	UPROPERTY(EditAnywhere, Category = Fire, meta = (ClampMin = 0.0))
 	float FireCooldown = 0.15f;
 };
\ No newline at end of file
@@ -0,0 +1,146 @@
+#include "FGProxyMovementSubsystem.h"
+#include "Async/ParallelFor.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "FGPlayer.h"
+#include "FGPlayerSettings.h"
+#include "../Components/FGMovementComponent.h"
+#include "../FGMovementStatics.h"
+#include "../Debug/FGNetStats.h"
+
+UFGProxyMovementSubsystem* UFGProxyMovementSubsystem::Get(const UObject* WorldContextObject)
+{
+	UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull);
+	return World != nullptr ? World->GetSubsystem<UFGProxyMovementSubsystem>() : nullptr;
+}
+
+void UFGProxyMovementSubsystem::RegisterPlayer(AFGPlayer* Player)
+{
+	Players.AddUnique(Player);
+}
+
+void UFGProxyMovementSubsystem::UnregisterPlayer(AFGPlayer* Player)
+{
+	Players.RemoveSwap(Player);
+}
+
+bool UFGProxyMovementSubsystem::IsBatching(const AFGPlayer& Player) const
+{
+	return bEnabled && !Player.IsLocallyControlled() && Player.PlayerSettings != nullptr;
+}
+
+bool UFGProxyMovementSubsystem::IsTickable() const
+{
+	return bEnabled && Players.Num() > 0;
+}
+
+ETickableTickType UFGProxyMovementSubsystem::GetTickableTickType() const
+{
+	return HasAnyFlags(RF_ClassDefaultObject) ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+TStatId UFGProxyMovementSubsystem::GetStatId() const
+{
+	return GET_STATID(STAT_FGProxyMovement);
+}
+
+void UFGProxyMovementSubsystem::Tick(float DeltaTime)
+{
+	CSV_SCOPED_TIMING_STAT(FGNet, ProxyMovement);
+
+	BatchedPlayers.Reset();
+	States.Reset();
+
+	// Nobody sees the proxies on a dedicated server, so only their simulation is needed
+	const bool bIsDedicatedServer = GetWorld()->IsNetMode(NM_DedicatedServer);
+
+	for (AFGPlayer* Player : Players)
+	{
+		if (Player == nullptr || !IsBatching(*Player))
+		{
+			continue;
+		}
+
+		FProxyState& State = States.AddDefaulted_GetRef();
+		State.Input = Player->GetMovementInput();
+		State.Settings = Player->PlayerSettings;
+		State.Velocity = Player->MovementVelocity;
+		State.Yaw = Player->Yaw;
+		State.Accumulator = Player->SimulationTimeAccumulator + DeltaTime;
+		State.SmoothingOffset = Player->NetworkSmoothingOffset;
+		State.bSmooth = !bIsDedicatedServer && Player->bPerformNetworkSmoothing;
+		State.SmoothingTime = State.bSmooth ? Player->GetNetworkSmoothingTime() : 0.0f;
+		BatchedPlayers.Add(Player);
+	}
+
+	if (BatchedPlayers.Num() == 0)
+	{
+		return;
+	}
+
+	SET_DWORD_STAT(STAT_FGBatchedProxies, BatchedPlayers.Num());
+
+	const float StepTime = BatchedPlayers[0]->GetSimulationStepTime();
+
+	ParallelFor(States.Num(), [this, DeltaTime, StepTime](int32 Index)
+	{
+		SimulateProxy(States[Index], DeltaTime, StepTime);
+	}, States.Num() < MinProxiesForParallel);
+
+	for (int32 Index = 0; Index < BatchedPlayers.Num(); ++Index)
+	{
+		AFGPlayer* Player = BatchedPlayers[Index];
+		const FProxyState& State = States[Index];
+
+		Player->MovementVelocity = State.Velocity;
+		Player->Yaw = State.Yaw;
+		Player->SimulationTimeAccumulator = State.Accumulator;
+		Player->NetworkSmoothingOffset = State.SmoothingOffset;
+
+		if (State.NumSteps > 0)
+		{
+			Player->MovementComponent->SetFacingYaw(State.Yaw);
+
+			FFGFrameMovement FrameMovement = Player->MovementComponent->CreateFrameMovement();
+			FrameMovement.AddDelta(State.MoveDelta);
+			Player->MovementComponent->Move(FrameMovement);
+
+			Player->PreviousSimulationLocation = Player->GetActorLocation() - State.LastStepDelta;
+		}
+
+		if (!bIsDedicatedServer)
+		{
+			Player->ApplyRenderOffset(StepTime);
+		}
+	}
+}
+
+void UFGProxyMovementSubsystem::SimulateProxy(FProxyState& State, float DeltaTime, float StepTime)
+{
+	FFGMovementModelState ModelState;
+	ModelState.Velocity = State.Velocity;
+	ModelState.Yaw = State.Yaw;
+
+	while (State.Accumulator >= StepTime && State.NumSteps < FFGMovementModel::MaxStepsPerFrame)
+	{
+		const FVector StepStart = ModelState.Location;
+		FFGMovementModel::Step(ModelState, State.Input, *State.Settings, StepTime);
+		State.LastStepDelta = ModelState.Location - StepStart;
+		State.Accumulator -= StepTime;
+		State.NumSteps++;
+	}
+
+	if (State.NumSteps == FFGMovementModel::MaxStepsPerFrame)
+	{
+		State.Accumulator = FMath::Fmod(State.Accumulator, StepTime);
+	}
+
+	State.MoveDelta = ModelState.Location;
+	State.Velocity = ModelState.Velocity;
+	State.Yaw = ModelState.Yaw;
+
+	if (State.bSmooth)
+	{
+		State.SmoothingOffset = FMath::VInterpTo(State.SmoothingOffset, FVector::ZeroVector, DeltaTime, 1.0f / State.SmoothingTime);
+	}
+}
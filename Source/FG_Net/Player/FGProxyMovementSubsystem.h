@@ -0,0 +1,66 @@
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "FGMovementModel.h"
+#include "FGProxyMovementSubsystem.generated.h"
+
+class AFGPlayer;
+class UFGPlayerSettings;
+
+// Simulates every player that isn't locally controlled in one pass after the actors have ticked.
+// The movement math runs in a ParallelFor over contiguous state, then each proxy gets a single sweep for all of its steps
+// this frame and its render offset on the game thread.
+UCLASS(Config = Engine)
+class FG_NET_API UFGProxyMovementSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+public:
+	static UFGProxyMovementSubsystem* Get(const UObject* WorldContextObject);
+
+	void RegisterPlayer(AFGPlayer* Player);
+	void UnregisterPlayer(AFGPlayer* Player);
+
+	// Whether this subsystem moves the player instead of the player's own tick
+	bool IsBatching(const AFGPlayer& Player) const;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+
+	UPROPERTY(Config)
+	bool bEnabled = true;
+
+	// Below this many proxies the math runs on the game thread, where it's cheaper than waking the workers
+	UPROPERTY(Config)
+	int32 MinProxiesForParallel = 16;
+
+private:
+	struct FProxyState
+	{
+		FFGMovementInput Input;
+		const UFGPlayerSettings* Settings = nullptr;
+		float Velocity = 0.0f;
+		float Yaw = 0.0f;
+		float Accumulator = 0.0f;
+		float SmoothingTime = 0.0f;
+		FVector SmoothingOffset = FVector::ZeroVector;
+		bool bSmooth = false;
+
+		// Results of the parallel pass
+		FVector MoveDelta = FVector::ZeroVector;
+		FVector LastStepDelta = FVector::ZeroVector;
+		int32 NumSteps = 0;
+	};
+
+	static void SimulateProxy(FProxyState& State, float DeltaTime, float StepTime);
+
+	UPROPERTY(Transient)
+	TArray<AFGPlayer*> Players;
+
+	// Rebuilt every frame, kept around so the allocations are too
+	TArray<AFGPlayer*> BatchedPlayers;
+	TArray<FProxyState> States;
+};
@@ -0,0 +1,273 @@
+#include "../Network/FGNetQuantize.h"
+#include "Math/RandomStream.h"
+#include "Misc/AutomationTest.h"
+#include "Serialization/BitReader.h"
+#include "Serialization/BitWriter.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace FGNetQuantizeTests
+{
+	static const int32 NumRandomSamples = 100000;
+
+	struct FErrorBound
+	{
+		int32 NumBits;
+		float MaxError;
+	};
+
+	// Atan2 rather than Acos, which can't resolve the small angles these tests measure
+	static float GetAngleDegrees(const FQuat& A, const FQuat& B)
+	{
+		const FQuat Delta = A * B.Inverse();
+		return FMath::RadiansToDegrees(2.0f * FMath::Atan2(FVector(Delta.X, Delta.Y, Delta.Z).Size(), FMath::Abs(Delta.W)));
+	}
+
+	static float GetAngleDegrees(const FVector& A, const FVector& B)
+	{
+		return FMath::RadiansToDegrees(FMath::Atan2(FVector::CrossProduct(A, B).Size(), FVector::DotProduct(A, B)));
+	}
+
+	static float RoundTripYaw(float Yaw, int32 NumBits)
+	{
+		return FFGNetQuantize::DequantizeYaw(FFGNetQuantize::QuantizeYaw(Yaw, NumBits), NumBits);
+	}
+
+	static float RoundTripBoundedFloat(float Value, float Bound, int32 NumBits)
+	{
+		return FFGNetQuantize::DequantizeBoundedFloat(FFGNetQuantize::QuantizeBoundedFloat(Value, Bound, NumBits), Bound, NumBits);
+	}
+
+	static FQuat RoundTripQuat(const FQuat& Quat, int32 BitsPerComponent)
+	{
+		return FFGNetQuantize::DequantizeQuat(FFGNetQuantize::QuantizeQuat(Quat, BitsPerComponent), BitsPerComponent);
+	}
+
+	static FVector RoundTripUnitVector(const FVector& Direction, int32 BitsPerAxis)
+	{
+		return FFGNetQuantize::DequantizeUnitVector(FFGNetQuantize::QuantizeUnitVector(Direction, BitsPerAxis), BitsPerAxis);
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFGNetQuantizeYawTest, "FGNet.Quantize.Yaw", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FFGNetQuantizeYawTest::RunTest(const FString& Parameters)
+{
+	using namespace FGNetQuantizeTests;
+
+	for (const int32 NumBits : { 8, 16 })
+	{
+		const float MaxError = 180.0f / static_cast<float>(1 << NumBits);
+		float WorstError = 0.0f;
+		int32 NumOutOfRange = 0;
+
+		// Two full turns either way, so negative and past 360 yaws are covered
+		for (int32 Step = -144000; Step <= 144000; ++Step)
+		{
+			const float Yaw = Step * 0.005f;
+			const float Result = RoundTripYaw(Yaw, NumBits);
+
+			WorstError = FMath::Max(WorstError, FMath::Abs(FMath::FindDeltaAngleDegrees(Yaw, Result)));
+			NumOutOfRange += Result < 0.0f || Result >= 360.0f ? 1 : 0;
+		}
+
+		TestTrue(*FString::Printf(TEXT("Worst yaw error %f at %d bits is within %f"), WorstError, NumBits, MaxError), WorstError <= MaxError + KINDA_SMALL_NUMBER);
+		TestEqual(*FString::Printf(TEXT("Yaws outside [0, 360) at %d bits"), NumBits), NumOutOfRange, 0);
+
+		TestEqual(TEXT("360 wraps to 0"), RoundTripYaw(360.0f, NumBits), 0.0f);
+		TestEqual(TEXT("720 wraps to 0"), RoundTripYaw(720.0f, NumBits), 0.0f);
+		TestEqual(TEXT("-180 wraps to 180"), RoundTripYaw(-180.0f, NumBits), 180.0f);
+		TestEqual(TEXT("-1 wraps to 359"), RoundTripYaw(-1.0f, NumBits), 359.0f, MaxError);
+		TestEqual(TEXT("Yaw rounding up to 360 wraps to 0"), RoundTripYaw(360.0f - MaxError * 0.5f, NumBits), 0.0f);
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFGNetQuantizeBoundedFloatTest, "FGNet.Quantize.BoundedFloat", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FFGNetQuantizeBoundedFloatTest::RunTest(const FString& Parameters)
+{
+	using namespace FGNetQuantizeTests;
+
+	for (const float Bound : { 1.0f, 1000.0f })
+	{
+		for (const int32 NumBits : { 4, 8, 12, 16 })
+		{
+			const uint32 MaxPacked = (1u << NumBits) - 1;
+			// Leaves room for float rounding in the mapping, which shows at 16 bits with large bounds
+			const float MaxError = Bound / MaxPacked * 1.01f;
+			float WorstError = 0.0f;
+
+			for (int32 Step = 0; Step <= NumRandomSamples; ++Step)
+			{
+				const float Value = FMath::Lerp(-Bound, Bound, static_cast<float>(Step) / NumRandomSamples);
+				WorstError = FMath::Max(WorstError, FMath::Abs(RoundTripBoundedFloat(Value, Bound, NumBits) - Value));
+			}
+
+			TestTrue(*FString::Printf(TEXT("Worst error %f at %d bits with bound %f is within %f"), WorstError, NumBits, Bound, MaxError), WorstError <= MaxError);
+
+			TestTrue(TEXT("-Bound packs to 0"), FFGNetQuantize::QuantizeBoundedFloat(-Bound, Bound, NumBits) == 0);
+			TestTrue(TEXT("Bound packs to the largest value"), FFGNetQuantize::QuantizeBoundedFloat(Bound, Bound, NumBits) == MaxPacked);
+			TestEqual(TEXT("-Bound round trips exactly"), RoundTripBoundedFloat(-Bound, Bound, NumBits), -Bound);
+			TestEqual(TEXT("Bound round trips exactly"), RoundTripBoundedFloat(Bound, Bound, NumBits), Bound);
+			TestEqual(TEXT("Values below the bound clamp"), RoundTripBoundedFloat(-10.0f * Bound, Bound, NumBits), -Bound);
+			TestEqual(TEXT("Values above the bound clamp"), RoundTripBoundedFloat(10.0f * Bound, Bound, NumBits), Bound);
+			TestEqual(TEXT("Bits above NumBits are ignored"), FFGNetQuantize::DequantizeBoundedFloat(~0u, Bound, NumBits), Bound);
+		}
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFGNetQuantizeQuatTest, "FGNet.Quantize.Quat", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FFGNetQuantizeQuatTest::RunTest(const FString& Parameters)
+{
+	using namespace FGNetQuantizeTests;
+
+	TArray<FQuat> Quats = {
+		FQuat::Identity,
+		FQuat(0.0f, 0.0f, 0.0f, -1.0f),
+		FQuat(0.0f, 0.0f, 0.0f, 2.0f),
+		FQuat(FVector::UpVector, PI),
+		FQuat(FVector::RightVector, -HALF_PI),
+		FQuat(FRotator(89.9f, -179.9f, 180.0f)),
+		FQuat(0.1f, 0.2f, 0.3f, -0.9f),
+		// Ties for the largest component
+		FQuat(0.5f, 0.5f, 0.5f, 0.5f),
+		FQuat(-0.5f, 0.5f, -0.5f, 0.5f),
+		FQuat(HALF_SQRT_2, -HALF_SQRT_2, 0.0f, 0.0f),
+		// Near the worst case, all components close to 0.5 so the rebuilt one is the least accurate
+		FQuat(0.48709f, -0.518329f, -0.512037f, 0.481556f),
+		FQuat(-0.487994f, 0.50874f, -0.492142f, 0.510727f),
+	};
+
+	FRandomStream RandomStream(1234);
+	for (int32 Index = 0; Index < NumRandomSamples; ++Index)
+	{
+		Quats.Add(FQuat(RandomStream.FRandRange(-1.0f, 1.0f), RandomStream.FRandRange(-1.0f, 1.0f), RandomStream.FRandRange(-1.0f, 1.0f), RandomStream.FRandRange(-1.0f, 1.0f)));
+	}
+
+	for (const FErrorBound& Bound : { FErrorBound{ 9, 0.53f }, FErrorBound{ 10, 0.27f } })
+	{
+		float WorstError = 0.0f;
+		for (const FQuat& Quat : Quats)
+		{
+			const FQuat Normalized = Quat.GetNormalized();
+			WorstError = FMath::Max(WorstError, GetAngleDegrees(RoundTripQuat(Normalized, Bound.NumBits), Normalized));
+		}
+
+		TestTrue(*FString::Printf(TEXT("Worst rotation error %f at %d bits is within %f"), WorstError, Bound.NumBits, Bound.MaxError), WorstError <= Bound.MaxError);
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFGNetQuantizeUnitVectorTest, "FGNet.Quantize.UnitVector", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FFGNetQuantizeUnitVectorTest::RunTest(const FString& Parameters)
+{
+	using namespace FGNetQuantizeTests;
+
+	TArray<FVector> Directions = {
+		FVector::ForwardVector,
+		FVector::BackwardVector,
+		FVector::RightVector,
+		FVector::LeftVector,
+		FVector::UpVector,
+		FVector::DownVector,
+		FVector(1.0f, 1.0f, 1.0f),
+		FVector(-1.0f, 1.0f, -1.0f),
+		FVector(-1.0f, -1.0f, -1.0f),
+		// Either side of the fold at the equator and around the folded pole
+		FVector(1.0f, -1.0f, 1e-4f),
+		FVector(1.0f, -1.0f, -1e-4f),
+		FVector(1e-6f, 0.0f, -1.0f),
+		FVector(-1e-6f, -1e-6f, -1.0f),
+		// Near the worst case
+		FVector(-0.539989f, 0.589847f, 0.60041f),
+		FVector(-0.563662f, -0.590826f, -0.577243f),
+	};
+
+	FRandomStream RandomStream(1234);
+	for (int32 Index = 0; Index < NumRandomSamples; ++Index)
+	{
+		Directions.Add(RandomStream.VRand());
+	}
+
+	for (const FErrorBound& Bound : { FErrorBound{ 8, 1.0f }, FErrorBound{ 12, 0.06f }, FErrorBound{ 16, 0.004f } })
+	{
+		float WorstError = 0.0f;
+		for (const FVector& Direction : Directions)
+		{
+			const FVector Normalized = Direction.GetSafeNormal();
+			WorstError = FMath::Max(WorstError, GetAngleDegrees(RoundTripUnitVector(Normalized, Bound.NumBits), Normalized));
+		}
+
+		TestTrue(*FString::Printf(TEXT("Worst direction error %f at %d bits per axis is within %f"), WorstError, Bound.NumBits, Bound.MaxError), WorstError <= Bound.MaxError);
+		TestTrue(TEXT("A zero vector comes back as forward"), GetAngleDegrees(RoundTripUnitVector(FVector::ZeroVector, Bound.NumBits), FVector::ForwardVector) <= Bound.MaxError);
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFGNetQuantizeSerializeTest, "FGNet.Quantize.Serialize", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FFGNetQuantizeSerializeTest::RunTest(const FString& Parameters)
+{
+	using namespace FGNetQuantizeTests;
+
+	const float Yaw = -90.0f;
+	const FQuat Quat(FRotator(10.0f, 20.0f, 30.0f));
+	const FVector Direction = FVector(1.0f, 2.0f, -3.0f).GetSafeNormal();
+	const FVector Vector(100.0f, -2500.0f, 40000.0f);
+	const float VectorBound = 2048.0f;
+
+	FBitWriter Writer(0, true);
+	{
+		float WrittenYaw = Yaw;
+		FQuat WrittenQuat = Quat;
+		FVector WrittenDirection = Direction;
+		FVector WrittenVector = Vector;
+		FFGNetQuantize::SerializeYaw(Writer, WrittenYaw, 10);
+		FFGNetQuantize::SerializeQuat(Writer, WrittenQuat, 9);
+		FFGNetQuantize::SerializeUnitVector(Writer, WrittenDirection, 12);
+		FFGNetQuantize::SerializeBoundedVector(Writer, WrittenVector, VectorBound, 12);
+
+		FFGNetQuantizedQuat QuantizedQuat(Quat);
+		bool bSuccess = false;
+		QuantizedQuat.NetSerialize(Writer, nullptr, bSuccess);
+		TestTrue(TEXT("Quantized quat serialized"), bSuccess);
+	}
+
+	const int32 ExpectedBits = 10 + (2 + 3 * 9) + 2 * 12 + 3 * 12 + (2 + 3 * FFGNetQuantizedQuat::BitsPerComponent);
+	TestEqual(TEXT("Bits written"), static_cast<int32>(Writer.GetNumBits()), ExpectedBits);
+
+	FBitReader Reader(Writer.GetData(), Writer.GetNumBits());
+	float ReadYaw = 0.0f;
+	FQuat ReadQuat = FQuat::Identity;
+	FVector ReadDirection = FVector::ZeroVector;
+	FVector ReadVector = FVector::ZeroVector;
+	FFGNetQuantize::SerializeYaw(Reader, ReadYaw, 10);
+	FFGNetQuantize::SerializeQuat(Reader, ReadQuat, 9);
+	FFGNetQuantize::SerializeUnitVector(Reader, ReadDirection, 12);
+	FFGNetQuantize::SerializeBoundedVector(Reader, ReadVector, VectorBound, 12);
+
+	FFGNetQuantizedQuat ReadQuantizedQuat;
+	bool bSuccess = false;
+	ReadQuantizedQuat.NetSerialize(Reader, nullptr, bSuccess);
+
+	TestFalse(TEXT("Reader error"), Reader.IsError());
+	TestTrue(TEXT("Reader consumed every bit"), Reader.AtEnd());
+
+	TestEqual(TEXT("Yaw"), ReadYaw, RoundTripYaw(Yaw, 10));
+	TestTrue(TEXT("Quat"), ReadQuat.Equals(RoundTripQuat(Quat, 9), 0.0f));
+	TestEqual(TEXT("Direction"), ReadDirection, RoundTripUnitVector(Direction, 12), 0.0f);
+	TestEqual(TEXT("Vector"), ReadVector, FVector(RoundTripBoundedFloat(Vector.X, VectorBound, 12), RoundTripBoundedFloat(Vector.Y, VectorBound, 12), VectorBound), 0.0f);
+	TestTrue(TEXT("Quantized quat"), bSuccess && ReadQuantizedQuat.Quat.Equals(RoundTripQuat(Quat, FFGNetQuantizedQuat::BitsPerComponent), 0.0f));
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
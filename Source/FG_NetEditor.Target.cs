@@ -9,6 +9,7 @@ public class FG_NetEditorTarget : TargetRules
 	{
 		Type = TargetType.Editor;
 		DefaultBuildSettings = BuildSettingsVersion.V2;
+		bWithPushModel = true;
 
 		ExtraModuleNames.AddRange( new string[] { "FG_Net" } );
 	}
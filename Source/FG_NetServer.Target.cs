@@ -0,0 +1,16 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+using UnrealBuildTool;
+using System.Collections.Generic;
+
+public class FG_NetServerTarget : TargetRules
+{
+	public FG_NetServerTarget(TargetInfo Target) : base(Target)
+	{
+		Type = TargetType.Server;
+		DefaultBuildSettings = BuildSettingsVersion.V2;
+		bWithPushModel = true;
+
+		ExtraModuleNames.AddRange( new string[] { "FG_Net" } );
+	}
+}